@@ -138,11 +138,26 @@ size_t calc_avail_size(size_t head, size_t tail) {
     }
 }
 
+#if defined(MWAIT_POLL) && !defined(NO_GEM5)
+// sleep on the index line instead of spinning: -DMWAIT_POLL
+const uint64_t MWAIT_TIMEOUT_CYCLES = 100000;
+
+inline void mwaitChange(volatile size_t* idx, size_t cur) {
+    appl::monitor(idx);
+    if (*idx == cur)
+        appl::mwait(MWAIT_TIMEOUT_CYCLES);
+}
+#endif
+
 size_t waitPush(size_t cur_tail, volatile size_t* head) {
     size_t cur_head, avail_size;
     do {
         cur_head = *head;
         avail_size = calc_avail_size(cur_head, cur_tail);
+#if defined(MWAIT_POLL) && !defined(NO_GEM5)
+        if (avail_size < 1)
+            mwaitChange(head, cur_head);
+#endif
     } while (avail_size < 1);
     return (cur_tail + 1) % queue_size;
 }
@@ -156,6 +171,10 @@ size_t waitPop(size_t cur_head, volatile size_t* tail) {
     do {
         cur_tail = *tail;
         used = queue_size - 1 - calc_avail_size(cur_head, cur_tail);
+#if defined(MWAIT_POLL) && !defined(NO_GEM5)
+        if (used < 1)
+            mwaitChange(tail, cur_tail);
+#endif
     } while (used < 1);
     return (cur_head + 1) % queue_size;
 }
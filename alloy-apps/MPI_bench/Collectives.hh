@@ -22,6 +22,14 @@
 #include <iostream>
 #include <chrono>
 
+// -DULI_DOORBELL: sleep on an L2 doorbell in WaitDoorbell instead of
+// spinning on the flag (gem5 builds only)
+// -DMWAIT_POLL: same, with monitor/mwait and a timeout
+#if (defined(ULI_DOORBELL) || defined(MWAIT_POLL)) && !defined(NO_GEM5)
+#include "appl.h"
+const uint64_t MWAIT_TIMEOUT_CYCLES = 100000;
+#endif
+
 using wordT = uint64_t;
 const size_t CACHE_LINE_SIZE = 64;
 volatile char* SEND_DUMMY = (volatile char*)(-1);
@@ -64,7 +72,25 @@ inline bool WaitDoorbellNb(volatile wordT* doorbell, wordT doorbellVal) {
 }
 
 inline void WaitDoorbell(volatile wordT* doorbell, wordT doorbellVal) {
+#if defined(ULI_DOORBELL) && !defined(NO_GEM5)
+    while (*doorbell != doorbellVal) {
+        // the arm returns once the watch is in place, so a release that
+        // raced with the first check is caught by the second one
+        appl::doorbell_arm(doorbell);
+        if (*doorbell == doorbellVal)
+            break;
+        appl::doorbell_wait();
+    }
+#elif defined(MWAIT_POLL) && !defined(NO_GEM5)
+    while (*doorbell != doorbellVal) {
+        appl::monitor(doorbell);
+        if (*doorbell == doorbellVal)
+            break;
+        appl::mwait(MWAIT_TIMEOUT_CYCLES);
+    }
+#else
     while (*doorbell != doorbellVal);
+#endif
 }
 
 inline void SetDoorbell(volatile wordT* doorbell, wordT doorbellVal) {
@@ -55,6 +55,20 @@ void* AllocRELMem(size_t count) {
     return ret;
 }
 
+void FreeNTMem(void* mem, size_t count) {
+#ifndef NO_GEM5
+    appl::unregister_stnt((uint64_t)mem, (uint64_t)mem + count);
+#endif
+    munmap(mem, count);
+}
+
+void FreeRELMem(void* mem, size_t count) {
+#ifndef NO_GEM5
+    appl::unregister_strel((uint64_t)mem, (uint64_t)mem + count);
+#endif
+    munmap(mem, count);
+}
+
 void BuildCSR(const std::string filename,
               size_t* row_ptr,
               size_t* col_idx) {
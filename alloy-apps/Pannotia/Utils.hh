@@ -30,4 +30,6 @@ void BuildCSR(const std::string filename,
 
 void* AllocREGMem(size_t count);
 void* AllocNTMem(size_t count);
-void* AllocRELMem(size_t count);
\ No newline at end of file
+void* AllocRELMem(size_t count);
+void FreeNTMem(void* mem, size_t count);
+void FreeRELMem(void* mem, size_t count);
\ No newline at end of file
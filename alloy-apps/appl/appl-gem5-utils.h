@@ -21,9 +21,37 @@ uint64_t get_cycles();
 
 void register_stnt(uint64_t begin, uint64_t end);
 void register_strel(uint64_t begin, uint64_t end);
+// drop [begin, end) from the ranges, e.g. before freeing a buffer
+void unregister_stnt(uint64_t begin, uint64_t end);
+void unregister_strel(uint64_t begin, uint64_t end);
 
 void gem5_barrier_init(uint64_t n_waiters);
+void gem5_barrier_init_id(uint64_t bar_id, uint64_t n_waiters);
 void gem5_barrier_wait(uint64_t bar_id);
+
+// sleep until the next store release to a registered ST_REL line: arm a
+// watch on the line, re-check the value, then wait for the doorbell
+void doorbell_arm(volatile void *addr);
+void doorbell_wait();
+
+// monitor/mwait: watch a line, re-check the value, then sleep until the
+// line changes hands or timeout_cycles (0: no timeout) pass
+void monitor(volatile void *addr);
+void mwait(uint64_t timeout_cycles);
+
+// per-hart DO event counters, counting up since the hart started. Read
+// them around a phase and subtract; the *_cycles fields are in the same
+// cycles as get_cycles(). All zero in targets other than RISC-V.
+struct do_counters {
+  uint64_t stnt;                 // ST_NTs issued
+  uint64_t strel;                // ST_RELs issued
+  uint64_t acq_stall_cycles;     // LD_ACQ issue to data
+  uint64_t rel_latency_cycles;   // ST_REL issue to its ack, summed
+  uint64_t barrier_wait_cycles;  // time in gem5_barrier_wait
+};
+
+do_counters get_do_counters();
+do_counters operator-(const do_counters &a, const do_counters &b);
 }
 
 #include "appl-gem5-utils.inl"
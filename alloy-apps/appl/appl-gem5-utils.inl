@@ -66,6 +66,34 @@ inline void register_strel(uint64_t begin, uint64_t end)
 #endif
 }
 
+inline void unregister_stnt(uint64_t begin, uint64_t end)
+{
+#ifdef APPL_ARCH_RISCV
+  __asm__ volatile ("csrw 0x7D0, %0;"
+                    :
+                    : "r" (begin)
+                    :);
+  __asm__ volatile ("csrw 0x7D9, %0;"
+                    :
+                    : "r" (end)
+                    :);
+#endif
+}
+
+inline void unregister_strel(uint64_t begin, uint64_t end)
+{
+#ifdef APPL_ARCH_RISCV
+  __asm__ volatile ("csrw 0x7E0, %0;"
+                    :
+                    : "r" (begin)
+                    :);
+  __asm__ volatile ("csrw 0x7E9, %0;"
+                    :
+                    : "r" (end)
+                    :);
+#endif
+}
+
 inline void gem5_barrier_init(uint64_t n_waiters)
 {
 #ifdef APPL_ARCH_RISCV
@@ -76,9 +104,26 @@ inline void gem5_barrier_init(uint64_t n_waiters)
 #endif
 }
 
+// waiter count of a single barrier id, overriding gem5_barrier_init
+inline void gem5_barrier_init_id(uint64_t bar_id, uint64_t n_waiters)
+{
+#ifdef APPL_ARCH_RISCV
+  __asm__ volatile ("csrw 0x7F1, %0;"
+                    :
+                    : "r" (bar_id)
+                    :);
+  __asm__ volatile ("csrw 0x7F2, %0;"
+                    :
+                    : "r" (n_waiters)
+                    :);
+#endif
+}
+
 inline void gem5_barrier_wait(uint64_t bar_id)
 {
 #ifdef APPL_ARCH_RISCV
+  // gem5 suspends this thread on the write until every waiter arrived,
+  // so the poll below normally succeeds on the first read
   __asm__ volatile ("csrw 0x7F8, %0;"
                     :
                     : "r" (bar_id)
@@ -94,4 +139,112 @@ inline void gem5_barrier_wait(uint64_t bar_id)
 #endif
 }
 
+inline void doorbell_poll()
+{
+#ifdef APPL_ARCH_RISCV
+  int ready = 0;
+  do {
+    __asm__ volatile ("csrr %0, %1;"
+                    : "=r"(ready)
+                    : "i"(0x791)
+                    :
+    );
+  } while (!ready);
+#endif
+}
+
+inline void doorbell_arm(volatile void *addr)
+{
+#ifdef APPL_ARCH_RISCV
+  // returns once the line's L2 registered the watch, so a release that
+  // lands after this call is guaranteed to ring
+  __asm__ volatile ("csrw 0x7C8, %0;"
+                    :
+                    : "r" (addr)
+                    : "memory");
+  doorbell_poll();
+#endif
+}
+
+inline void doorbell_wait()
+{
+#ifdef APPL_ARCH_RISCV
+  __asm__ volatile ("csrw 0x7C9, zero;"
+                    :
+                    :
+                    : "memory");
+  doorbell_poll();
+#endif
+}
+
+inline void mwait_poll()
+{
+#ifdef APPL_ARCH_RISCV
+  int ready = 0;
+  do {
+    __asm__ volatile ("csrr %0, %1;"
+                    : "=r"(ready)
+                    : "i"(0x792)
+                    :
+    );
+  } while (!ready);
+#endif
+}
+
+inline void monitor(volatile void *addr)
+{
+#ifdef APPL_ARCH_RISCV
+  // ST_REL lines also arm a doorbell, which may suspend until the L2 acks
+  __asm__ volatile ("csrw 0x7CA, %0;"
+                    :
+                    : "r" (addr)
+                    : "memory");
+  mwait_poll();
+#endif
+}
+
+inline void mwait(uint64_t timeout_cycles)
+{
+#ifdef APPL_ARCH_RISCV
+  __asm__ volatile ("csrw 0x7CB, %0;"
+                    :
+                    : "r" (timeout_cycles)
+                    : "memory");
+  mwait_poll();
+#endif
+}
+
+#ifdef APPL_ARCH_RISCV
+#define APPL_READ_CSR(csr, dst) \
+  __asm__ volatile ("csrr %0, %1;" : "=r"(dst) : "i"(csr) :)
+#endif
+
+inline do_counters get_do_counters()
+{
+  do_counters c = {0, 0, 0, 0, 0};
+#ifdef APPL_ARCH_RISCV
+  APPL_READ_CSR(0xCC0, c.stnt);
+  APPL_READ_CSR(0xCC1, c.strel);
+  APPL_READ_CSR(0xCC2, c.acq_stall_cycles);
+  APPL_READ_CSR(0xCC3, c.rel_latency_cycles);
+  APPL_READ_CSR(0xCC4, c.barrier_wait_cycles);
+#endif
+  return c;
+}
+
+#ifdef APPL_ARCH_RISCV
+#undef APPL_READ_CSR
+#endif
+
+inline do_counters operator-(const do_counters &a, const do_counters &b)
+{
+  do_counters d;
+  d.stnt                = a.stnt - b.stnt;
+  d.strel               = a.strel - b.strel;
+  d.acq_stall_cycles    = a.acq_stall_cycles - b.acq_stall_cycles;
+  d.rel_latency_cycles  = a.rel_latency_cycles - b.rel_latency_cycles;
+  d.barrier_wait_cycles = a.barrier_wait_cycles - b.barrier_wait_cycles;
+  return d;
+}
+
 } // namespace appl
\ No newline at end of file
@@ -26,6 +26,7 @@ import m5
 from m5.defines import buildEnv
 from m5.objects import *
 from m5.util import addToPath, fatal, warn
+from m5.util.convert import toFrequency
 
 addToPath('../')
 
@@ -248,12 +249,17 @@ cooldown_cpu_list = None
 
 main_switched_out = False
 
+# Restoring an ROI checkpoint starts directly on the main CPUs. The thread
+# state recorded from the warmup CPUs is loaded into them by name.
+restore_roi = (options.brg_restore_roi is not None)
+
 if (options.brg_fast_forward):
-  warmup_cpu_list   = [ WarmupCPUClass(cpu_id = i) \
+  if not restore_roi:
+    warmup_cpu_list = [ WarmupCPUClass(cpu_id = i) \
                                         for i in xrange(np) ]
+    main_switched_out = True
   cooldown_cpu_list = [ CooldownCPUClass(switched_out = True, cpu_id = i) \
                                         for i in xrange(np) ]
-  main_switched_out = True
 
 if options.big_tiny:
   TinyCPUClass, _ = Simulation.getCPUClass(options.tiny_cpu_type)
@@ -270,14 +276,23 @@ else:
 
 assert(len(main_cpu_list) == np)
 
+# The DO sequencers rely on the in-order issue of the simple CPUs. An O3 LSQ
+# can issue a load past an LD_ACQ, and nothing orders it, so DerivO3CPU is
+# not supported on the DO protocols.
+if options.ruby and buildEnv['PROTOCOL'] in ('DO_MESI', 'MP') and \
+   any(cpu.type == 'DerivO3CPU' for cpu in main_cpu_list):
+  fatal("DerivO3CPU is not supported with the %s protocol" % \
+        buildEnv['PROTOCOL'])
+
 #------------------------------------------------------------------------------
 # Create the top-level system
 #------------------------------------------------------------------------------
 
 # If fast_forward is enabled, the system will start with WarmupCPUClass.
-# Otherwise, it will start with MainCPUClass
+# Otherwise, or when restoring an ROI checkpoint, it will start with
+# MainCPUClass
 
-if (options.brg_fast_forward):
+if warmup_cpu_list:
   system = System(cpu             = warmup_cpu_list,
                   mem_mode        = WarmupCPUClass.memory_mode(),
                   mem_ranges      = [AddrRange(options.mem_size)],
@@ -417,26 +432,73 @@ if options.active_message_network and np >= 2:
     system.cpu[i].out_nw_req_port = adapters[i].cpu_req_port
     adapters[i].network_req_port  = system.cpu[i].in_nw_req_port
 
+#------------------------------------------------------------------------------
+# Partition the system for parallel simulation
+#------------------------------------------------------------------------------
+
+# --parallel-nodes: the main CPUs and the memory controller of node n join
+# its routers and Ruby controllers on event queue n (see TwoMeshXY), and each
+# queue runs on its own host thread. Only CG links cross queues, so the
+# queues synchronize once per CG link latency.
+#
+# The warmup and cooldown CPUs stay on queue 0. Inside the ROI the CPUs
+# translate through the SE page table without a lock, so the page-table
+# syscalls and stack growth wait for a handoff at a quantum boundary, where
+# every queue stops; so do the wake-ups of suspended threads (barriers,
+# doorbells, mwait). See System::handoffQuantum.
+#
+# Experimental: futex syscalls are not thread-safe, cross-node
+# synchronization should use the gem5 barriers. The handoffs delay a thread
+# by one to two quanta, so compare with a --parallel-reference run (serial,
+# same handoffs), not a plain serial one:
+# scripts/run_parallel_check.sh and scripts/compare_parallel_stats.py.
+if options.parallel_nodes or options.parallel_reference:
+  if options.parallel_nodes and options.parallel_reference:
+    fatal("--parallel-nodes and --parallel-reference are exclusive")
+  if not options.ruby:
+    fatal("--parallel-nodes requires --ruby")
+  if not options.brg_fast_forward:
+    fatal("--parallel-nodes requires --brg-fast-forward")
+
+  # ticks are ps; stay one cycle below the CG link latency
+  parallel_quantum = int((options.CG_link_latency - 1) * 1e12 /
+                         toFrequency(options.ruby_clock))
+  system.handoff_quantum = parallel_quantum
+
+if options.parallel_nodes:
+  cpus_per_node = np // options.num_l2caches
+  for (i, cpu) in enumerate(main_cpu_list):
+    cpu.eventq_index = i // cpus_per_node
+  # one memory controller per directory and memory range
+  mem_ctrls_per_node = len(system.mem_ctrls) // options.num_l2caches
+  for (i, mem_ctrl) in enumerate(system.mem_ctrls):
+    mem_ctrl.eventq_index = i // mem_ctrls_per_node
+
 #------------------------------------------------------------------------------
 # Create root object
 #------------------------------------------------------------------------------
 
 root = Root(full_system = False, system = system)
 
+if options.parallel_nodes:
+  root.sim_quantum = parallel_quantum
+
 #------------------------------------------------------------------------------
 # Set up for fast-forward mode
 #------------------------------------------------------------------------------
 
 if options.brg_fast_forward:
   for i in xrange(np):
-    copy_cpu_configs(warmup_cpu_list[i], main_cpu_list[i])
+    if warmup_cpu_list:
+      copy_cpu_configs(warmup_cpu_list[i], main_cpu_list[i])
     copy_cpu_configs(main_cpu_list[i],   cooldown_cpu_list[i])
 
-  system.main_cpu     = main_cpu_list
+  if warmup_cpu_list:
+    system.main_cpu = main_cpu_list
+    switch_warmup_cpu_pairs = [ ( warmup_cpu_list[i], main_cpu_list[i] ) \
+                                        for i in xrange(np) ]
   system.cooldown_cpu = cooldown_cpu_list
 
-  switch_warmup_cpu_pairs   = [ ( warmup_cpu_list[i], main_cpu_list[i] ) \
-                                        for i in xrange(np) ]
   switch_cooldown_cpu_pairs = [ ( main_cpu_list[i], cooldown_cpu_list[i] ) \
                                         for i in xrange(np) ]
 
@@ -445,6 +507,14 @@ if options.brg_fast_forward:
 #------------------------------------------------------------------------------
 
 checkpoint_dir = None
+if options.brg_checkpoint_warmup and not options.brg_checkpoint_roi:
+  fatal("--brg-checkpoint-warmup requires --brg-checkpoint-roi")
+if options.brg_checkpoint_roi or restore_roi:
+  if not options.brg_fast_forward:
+    fatal("ROI checkpoints require --brg-fast-forward")
+  if options.brg_checkpoint_roi and restore_roi:
+    fatal("Cannot take and restore an ROI checkpoint in the same run")
+  checkpoint_dir = options.brg_restore_roi
 m5.instantiate(checkpoint_dir)
 
 maxtick = m5.MaxTick
@@ -465,35 +535,83 @@ def checkExitEvent(exit_event):
     sys.exit(exit_event.getCode())
 
 if options.brg_fast_forward:
-  print("\n\n----- Entering warmup simulation -----\n")
-  exit_event = m5.simulate(maxtick)
-  print("\n\n----- Exiting warmup simulation @ tick %i because %s -----\n\n" %\
-                                (m5.curTick(), exit_event.getCause()))
-  checkExitEvent(exit_event)
-
-  print("\n\n----- Switching to main CPUs ----\n")
-  exit_event = m5.switchCpus(system, switch_warmup_cpu_pairs)
-  checkExitEvent(exit_event)
-
-  print("\n\n----- Entering main simulation -----\n")
-  exit_event = m5.simulate(maxtick - m5.curTick())
-  print("\n\n----- Exiting main simulation @ tick %i because %s -----\n\n" %\
-                                (m5.curTick(), exit_event.getCause()))
-  checkExitEvent(exit_event)
-
-  # FIXME: @Tuan Switching back to non-caching atomic simple CPU is not working
-  # yet with Ruby, so turn it off for now.
-  warn("Cooldown phase that may contain verification code is off\n")
-
-#  print("\n\n----- Switching to cooldown CPUs -----\n")
-#  exit_event = m5.switchCpus(system, switch_cooldown_cpu_pairs)
-#  checkExitEvent(exit_event)
-#
-#  print("\n\n----- Entering cooldown simulation -----\n")
-#  exit_event = m5.simulate(maxtick - m5.curTick())
-#  print("\n\n----- Exiting cooldown simulation @ tick %i because %s ----\n\n"\
-#                              % (m5.curTick(), exit_event.getCause()))
-#  checkExitEvent(exit_event)
+  if restore_roi:
+    # ROI checkpoints are taken at the first toggle_stats(true), or
+    # --brg-checkpoint-warmup ticks after it, so the restored main CPUs
+    # are already inside the ROI. Ruby warms its caches from the
+    # checkpointed cache trace during startup.
+    print("\n\n----- Restored ROI checkpoint from %s -----\n" % \
+                                checkpoint_dir)
+    reached_roi = True
+  else:
+    print("\n\n----- Entering warmup simulation -----\n")
+    exit_event = m5.simulate(maxtick)
+    print("\n\n----- Exiting warmup simulation @ tick %i because %s -----\n\n"\
+                                % (m5.curTick(), exit_event.getCause()))
+    checkExitEvent(exit_event)
+
+    # The warmup phase ends on the first toggle_stats(true), which raises a
+    # "switchcpu" exit. Any other exit means the workload finished without
+    # ever entering its ROI, so there is nothing to simulate in detail.
+    reached_roi = (exit_event.getCause() == "switchcpu")
+
+  if not reached_roi:
+    warn("Workload exited during warmup without reaching its ROI\n")
+  elif options.brg_checkpoint_roi:
+    # The warmup CPUs bypass Ruby, so at the start of the ROI the caches and
+    # DO tables are as cold as after the switch to the main CPUs. To record
+    # them warm, run the start of the ROI on the main CPUs, then switch
+    # back: the restored run loads the warmup CPUs' thread state by name.
+    if options.brg_checkpoint_warmup > 0:
+      print("\n\n----- Warming up Ruby for the ROI checkpoint -----\n")
+      exit_event = m5.switchCpus(system, switch_warmup_cpu_pairs)
+      checkExitEvent(exit_event)
+      exit_event = m5.simulate(options.brg_checkpoint_warmup)
+      checkExitEvent(exit_event)
+      if exit_event.getCause() != "simulate() limit reached":
+        fatal("The ROI ended within --brg-checkpoint-warmup (%s)" % \
+              exit_event.getCause())
+      exit_event = m5.switchCpus(system, [ (main, warmup) for (warmup, main) \
+                                           in switch_warmup_cpu_pairs ])
+      checkExitEvent(exit_event)
+
+    # m5.checkpoint drains the system and calls memWriteback, which records
+    # the Ruby cache trace that RubySystem::serialize needs.
+    cpt_dir = os.path.join(options.checkpoint_dir or m5.options.outdir,
+                           "cpt.roi")
+    print("\n\n----- Writing ROI checkpoint to %s -----\n" % cpt_dir)
+    m5.checkpoint(cpt_dir)
+  else:
+    if not restore_roi:
+      print("\n\n----- Switching to main CPUs ----\n")
+      exit_event = m5.switchCpus(system, switch_warmup_cpu_pairs)
+      checkExitEvent(exit_event)
+
+    print("\n\n----- Entering main simulation -----\n")
+    exit_event = m5.simulate(maxtick - m5.curTick())
+    print("\n\n----- Exiting main simulation @ tick %i because %s -----\n\n" %\
+                                  (m5.curTick(), exit_event.getCause()))
+    checkExitEvent(exit_event)
+
+    # The timing region ends with a "switchcpu" exit when stats are turned
+    # off. Any other exit (e.g., the workload finished) leaves nothing to run.
+    if options.brg_do_cooldown and exit_event.getCause() == "switchcpu":
+      # Switching to atomic_noncaching makes m5.switchCpus drain Ruby and call
+      # RubySystem::memWriteback, which functionally writes every dirty line
+      # back through the directories. The atomic CPUs then access memory
+      # directly through RubyPort::recvAtomic, so the (now stale) cache
+      # contents are never read again.
+      print("\n\n----- Switching to cooldown CPUs -----\n")
+      exit_event = m5.switchCpus(system, switch_cooldown_cpu_pairs)
+      checkExitEvent(exit_event)
+
+      print("\n\n----- Entering cooldown simulation -----\n")
+      exit_event = m5.simulate(maxtick - m5.curTick())
+      print("\n\n----- Exiting cooldown simulation @ tick %i because %s "\
+            "----\n\n" % (m5.curTick(), exit_event.getCause()))
+      checkExitEvent(exit_event)
+    elif not options.brg_do_cooldown:
+      warn("Cooldown phase that may contain verification code is off\n")
 else:
   print("\n\n----- Entering main simulation -----\n")
   exit_event = m5.simulate(maxtick)
@@ -418,8 +418,28 @@ def addBRGOptions(parser):
 
     # Option to run cooldown phase after finishing the main simulation
     parser.add_option('--brg-do-cooldown', action='store_true',
-                      help="Skip cooldown phase (valid only if \
-                            brg-fast-forward is set)")
+                      help="Switch back to atomic CPUs after the timing \
+                            region (valid only if brg-fast-forward is set)")
+
+    # Checkpoint at the first toggle_stats(true) and restore from it so that
+    # sweeps over Ruby parameters skip dataset loading and thread startup
+    parser.add_option('--brg-checkpoint-roi', action='store_true',
+                      help="Take a checkpoint when the workload enters its \
+                            ROI and exit (requires brg-fast-forward). It is \
+                            written to checkpoint-dir, or the output \
+                            directory if unset")
+    parser.add_option('--brg-restore-roi', action='store', type='string',
+                      default=None,
+                      help="Restore from a checkpoint taken with \
+                            brg-checkpoint-roi and start on the main CPUs. \
+                            Ruby parameters may differ from the run that \
+                            took it; the CPU and L2 counts may not")
+    parser.add_option('--brg-checkpoint-warmup', action='store', type='int',
+                      default=0,
+                      help="Run this many ticks of the ROI on the main CPUs \
+                            before taking the brg-checkpoint-roi checkpoint, \
+                            so that it records warm caches and DO tables. \
+                            The restored run starts that far into the ROI")
 
     # Enable CPU activity trace
     parser.add_option("--activity-trace", action="store_true",
@@ -494,4 +514,18 @@ def addBRGSC3Options(parser):
     parser.add_option("--tiny_l1i_assoc", type="int", default=2)
 
 def addDOOptions(parser):
-    parser.add_option('--CG_link_latency', type="int", default="600")    
\ No newline at end of file
+    # default 600, or the --CG-link-preset latency (see Network.py)
+    parser.add_option('--CG_link_latency', type="int", default=None)
+    # inter-node (CG) fabric between the per-node L2 routers
+    parser.add_option('--inter-node-fabric', type="choice", default="switch",
+                      choices=['switch', 'multi_switch', 'ring', 'mesh',
+                               'torus', 'fc'],
+                      help="""how node routers are connected over CG links.
+                            switch: one central switch (default)
+                            multi_switch: --num-root-switches parallel switches
+                            ring/mesh/torus/fc: direct node-to-node links""")
+    parser.add_option('--num-root-switches', type="int", default=2,
+                      help="number of parallel root switches (multi_switch)")
+    parser.add_option('--inter-node-rows', type="int", default=0,
+                      help="""rows of the node-router mesh/torus.
+                            0 picks the squarest factorization""")
@@ -43,6 +43,20 @@ from m5.objects import *
 from m5.defines import buildEnv
 from m5.util import addToPath, fatal
 
+# CG link presets, in cycles of the default 2GHz Ruby clock and bytes per
+# direction. The latencies match the ones used for the CXL/UPI runs in
+# scripts/run_storage.sh.
+# cxl: x16 at 32 GT/s (64 GB/s), 68B flits carrying 64B. A 16B network
+#      flit takes 17B, under one cycle, so the link keeps up with the router.
+# upi: 20 lanes at 10.4 GT/s (26 GB/s), 10B flits carrying 8B. A 16B
+#      network flit takes 20B, about 1.54 cycles.
+cg_link_presets = {
+    'cxl': { 'latency': 150, 'bandwidth': 32, 'flit_size': 64,
+             'flit_overhead': 4, 'serialization_latency': 2 },
+    'upi': { 'latency': 50, 'bandwidth': 13, 'flit_size': 8,
+             'flit_overhead': 2, 'serialization_latency': 1 },
+}
+
 def define_options(parser):
     # By default, ruby uses the simple timing cpu
     parser.set_defaults(cpu_type="TimingSimpleCPU")
@@ -82,7 +96,10 @@ def define_options(parser):
                       help="""routing algorithm in network.
                             0: weight-based table
                             1: XY (for Mesh. see garnet2.0/RoutingUnit.cc)
-                            2: Custom (see garnet2.0/RoutingUnit.cc""")
+                            2: Custom (see garnet2.0/RoutingUnit.cc
+                            3: Adaptive, congestion-aware choice among the
+                               minimal-weight table routes
+                               (see garnet2.0/GarnetNetwork.cc)""")
     parser.add_option("--network-fault-model", action="store_true",
                       default=False,
                       help="""enable network fault model:
@@ -94,9 +111,63 @@ def define_options(parser):
                       default=0,
                       help="""maximal buffer size in the network
                               (0 means infinite)""")
+    # CG (inter-node) link bandwidth model, see garnet2.0/GarnetLink.py
+    parser.add_option("--CG-link-preset", type="choice", default="none",
+                      choices=['none'] + sorted(cg_link_presets.keys()),
+                      help="""CG link latency/bandwidth/flit size preset.
+                            --CG_link_latency and the --CG-* options below
+                            override the preset.""")
+    parser.add_option("--CG-link-bandwidth", action="store", type="float",
+                      default=None,
+                      help="""CG link bandwidth in bytes/cycle, may be
+                            fractional (0: unlimited)""")
+    parser.add_option("--CG-flit-size", action="store", type="int",
+                      default=None,
+                      help="CG link-level flit payload in bytes")
+    parser.add_option("--CG-flit-overhead", action="store", type="int",
+                      default=None,
+                      help="CG link-level header/CRC bytes per flit")
+    parser.add_option("--CG-serialization-latency", action="store",
+                      type="int", default=None,
+                      help="CG link SerDes latency in cycles")
+    parser.add_option("--parallel-nodes", action="store_true",
+                      help="""simulate each node (and root switch) of the
+                            TwoMeshXY topology on its own event queue and
+                            host thread. Experimental, see configs/brg/sc3.py
+                            for the limitations.""")
+    parser.add_option("--parallel-reference", action="store_true",
+                      help="""simulate serially, but hand SE state changes
+                            off like --parallel-nodes does, for a reference
+                            run to compare a --parallel-nodes run with.""")
+
+def apply_cg_link_preset(options):
+    preset = cg_link_presets.get(options.CG_link_preset, {})
+    if options.CG_link_latency == None:
+        options.CG_link_latency = preset.get('latency', 600)
+    if options.CG_link_bandwidth == None:
+        options.CG_link_bandwidth = preset.get('bandwidth', 0)
+    if options.CG_flit_size == None:
+        options.CG_flit_size = preset.get('flit_size', 0)
+    if options.CG_flit_overhead == None:
+        options.CG_flit_overhead = preset.get('flit_overhead', 0)
+    if options.CG_serialization_latency == None:
+        options.CG_serialization_latency = \
+            preset.get('serialization_latency', 0)
 
 def create_network(options, ruby):
 
+    apply_cg_link_preset(options)
+
+    # Adaptive routing has no escape VCs to fall back on (the VC allocator
+    # is not part of this tree), so it is only deadlock-free under link
+    # weights that allow a single dimension order, as TwoMeshXY sets them.
+    if options.routing_algorithm == 3 and options.topology != "TwoMeshXY":
+        fatal("--routing-algorithm 3 needs the TwoMeshXY link weights")
+
+    if options.parallel_nodes and (options.network != "garnet2.0" or
+                                   options.topology != "TwoMeshXY"):
+        fatal("--parallel-nodes needs garnet2.0 and the TwoMeshXY topology")
+
     # Set the network classes based on the command line options
     if options.network == "garnet2.0":
         NetworkClass = GarnetNetwork
@@ -140,6 +211,13 @@ def init_network(options, network, InterfaceClass):
                   for (i,n) in enumerate(network.ext_links)]
         network.netifs = netifs
 
+        # An NI runs on the event queue of its controller. TwoMeshXY adds
+        # the ext links in MachineType order, so NI i serves ext link i
+        # (checked in NetworkInterface::addNode).
+        if options.parallel_nodes:
+            for (ni, link) in zip(netifs, network.ext_links):
+                ni.eventq_index = link.eventq_index
+
     if options.network_fault_model:
         assert(options.network == "garnet2.0")
         network.enable_fault_model = True
@@ -119,7 +119,7 @@ def create_system(options, full_system, system, dma_ports, bootmem,
 
         cpu_seq = DOSequencer(version = i, icache = l1i_cache,
                                 dcache = l1d_cache, clk_domain = clk_domain,
-                                ruby_system = ruby_system)
+                                ruby_system = ruby_system, doorbells = True)
 
 
         l1_cntrl.sequencer = cpu_seq
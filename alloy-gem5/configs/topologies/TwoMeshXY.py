@@ -37,14 +37,21 @@
 #
 # Authors: Brad Beckmann
 
+import math
+
 from m5.params import *
 from m5.objects import *
+from m5.util import fatal
 
 from BaseTopology import SimpleTopology
 
 # Creates a Mesh topology with 4 directories, one at each corner.
 # One L1 (and L2, depending on the protocol) are connected to each router.
 # XY routing is enforced (using link weights) to guarantee deadlock freedom.
+#
+# Each node (a group of L1s plus one L2/dir) hangs off its own L2 router.
+# The node routers are tied together over CG links by the inter-node fabric
+# selected with --inter-node-fabric (see makeInterNodeFabric below).
 
 class TwoMeshXY(SimpleTopology):
     description='TwoMeshXY'
@@ -59,7 +66,6 @@ class TwoMeshXY(SimpleTopology):
         # default values for link latency and router latency.
         # Can be over-ridden on a per link/router basis
         link_latency = options.link_latency # used by simple and garnet
-        interPU_link_latency = options.CG_link_latency
         router_latency = options.router_latency # only used by garnet
 
 
@@ -84,7 +90,15 @@ class TwoMeshXY(SimpleTopology):
         assert(len(l2cache_nodes) == len(dir_nodes))
         assert(num_cpus % len(l2cache_nodes) == 0)
         num_l2caches = len(l2cache_nodes)
-        num_routers = num_cpus + num_l2caches + 1
+        fabric = options.inter_node_fabric
+        if fabric == 'switch':
+            num_root_switches = 1
+        elif fabric == 'multi_switch':
+            num_root_switches = options.num_root_switches
+            assert(num_root_switches >= 1)
+        else:
+            num_root_switches = 0
+        num_routers = num_cpus + num_l2caches + num_root_switches
         num_cpus_per_l2cache = num_cpus // num_l2caches
 
         # Create the routers in the mesh
@@ -132,6 +146,22 @@ class TwoMeshXY(SimpleTopology):
 
         network.ext_links = ext_links
 
+        # --parallel-nodes: node n (its L1 routers, its node router and
+        # every controller hanging off them) runs on event queue n, root
+        # switch j on queue num_l2caches + j. Only CG links cross queues.
+        self.parallel = options.parallel_nodes
+        if self.parallel:
+            def partition(router_id):
+                if router_id < num_cpus:
+                    return router_id // num_cpus_per_l2cache
+                return router_id - num_cpus
+            for (i, router) in enumerate(routers):
+                router.eventq_index = partition(i)
+            # links are children of the network (queue 0) otherwise
+            for link in ext_links:
+                link.eventq_index = link.int_node.eventq_index
+                link.ext_node.eventq_index = link.int_node.eventq_index
+
         # Create the mesh links.
         int_links = []
         
@@ -147,18 +177,129 @@ class TwoMeshXY(SimpleTopology):
                                      dst_node=routers[router_id],
                                      latency = link_latency))
             link_count += 1
+        if self.parallel:
+            for link in int_links:
+                link.eventq_index = link.src_node.eventq_index
         
-        for router_id in range(num_cpus, num_cpus + num_l2caches):
-            root_router_id = num_cpus + num_l2caches
-            int_links.append(IntLink(link_id=link_count,
-                                     src_node=routers[router_id],
-                                     dst_node=routers[root_router_id],
-                                     latency = interPU_link_latency))
-            link_count += 1
-            int_links.append(IntLink(link_id=link_count,
-                                     src_node=routers[root_router_id],
-                                     dst_node=routers[router_id],
-                                     latency = interPU_link_latency))
-            link_count += 1
+        node_router_ids = range(num_cpus, num_cpus + num_l2caches)
+        root_router_ids = range(num_cpus + num_l2caches, num_routers)
+        int_links += self.makeInterNodeFabric(options, routers,
+                                              node_router_ids,
+                                              root_router_ids,
+                                              IntLink, link_count)
 
         network.int_links = int_links
+
+    # Connects the node routers over CG links.
+    #   switch       : every node router to one central switch
+    #   multi_switch : every node router to each of the parallel switches;
+    #                  all uplinks have the same weight so the routing unit
+    #                  may pick any switch (see --routing-algorithm 3)
+    #   fc           : a direct link between every pair of node routers
+    #   ring         : node i to node (i + 1) % num_nodes
+    #   mesh/torus   : node routers on an --inter-node-rows x cols grid with
+    #                  XY weights; torus adds the wrap-around links
+    #
+    # The routers have no dateline VCs, so the link weights alone must keep
+    # the minimal-weight routes (TABLE_ and adaptive routing both use only
+    # those) free of cyclic channel dependencies. On each ring (the ring
+    # fabric, every torus row and column) the links into the first router
+    # weigh more than any route around the other side, so no route passes
+    # through that dateline router and the ring acts as a line for
+    # dependencies. On the torus every Y link also weighs more than any X
+    # link, which keeps the routes in XY order.
+    def makeInterNodeFabric(self, options, routers, node_ids, root_ids,
+                            IntLink, link_count):
+        fabric = options.inter_node_fabric
+        interPU_link_latency = options.CG_link_latency
+        num_nodes = len(node_ids)
+        links = []
+
+        def connect(src, dst, weight = 1, rev_weight = None):
+            # CG links are bi-directional, one IntLink per direction
+            if rev_weight is None:
+                rev_weight = weight
+            for (s, d, w) in [(src, dst, weight), (dst, src, rev_weight)]:
+                link = IntLink(link_id=link_count + len(links),
+                               src_node=routers[s],
+                               dst_node=routers[d],
+                               latency = interPU_link_latency,
+                               weight = w)
+                if options.network == "garnet2.0":
+                    link.network_link.link_bandwidth = \
+                        options.CG_link_bandwidth
+                    link.network_link.link_flit_size = options.CG_flit_size
+                    link.network_link.link_flit_overhead = \
+                        options.CG_flit_overhead
+                    link.network_link.serialization_latency = \
+                        options.CG_serialization_latency
+                if self.parallel:
+                    # flits are sent by the source router, credits by the
+                    # destination router (see NetworkLink::wakeup)
+                    link.network_link.eventq_index = \
+                        routers[s].eventq_index
+                    link.credit_link.eventq_index = \
+                        routers[d].eventq_index
+                links.append(link)
+
+        if fabric == 'switch' or fabric == 'multi_switch':
+            for root_id in root_ids:
+                for node_id in node_ids:
+                    connect(node_id, root_id)
+        elif fabric == 'fc':
+            for i in range(num_nodes):
+                for j in range(i + 1, num_nodes):
+                    connect(node_ids[i], node_ids[j])
+        elif fabric == 'ring':
+            # links into node 0 (the dateline) weigh more than the
+            # num_nodes - 1 hops of any route around the other side
+            def ring_weight(j):
+                return num_nodes if j == 0 else 1
+            for i in range(num_nodes):
+                j = (i + 1) % num_nodes
+                # a 2-node ring is a single link pair
+                if j > i or num_nodes > 2:
+                    connect(node_ids[i], node_ids[j],
+                            ring_weight(j), ring_weight(i))
+        elif fabric == 'mesh' or fabric == 'torus':
+            num_rows = options.inter_node_rows
+            if num_rows == 0:
+                num_rows = int(math.sqrt(num_nodes))
+                while num_nodes % num_rows != 0:
+                    num_rows -= 1
+            num_cols = num_nodes // num_rows
+            assert(num_rows * num_cols == num_nodes)
+            wrap = (fabric == 'torus')
+            x_wrap = wrap and num_cols > 2
+            y_wrap = wrap and num_rows > 2
+            # X links weigh 1 and those into column 0 (the X dateline)
+            # num_cols. Y links weigh more than any X link, those into
+            # row 0 (the Y dateline) num_rows times as much.
+            x_dateline = num_cols if x_wrap else 1
+            y_weight = x_dateline + 1
+            y_dateline = num_rows * y_weight if y_wrap else y_weight
+            def x_weight(col):
+                return x_dateline if col == 0 else 1
+            def y_link_weight(row):
+                return y_dateline if row == 0 else y_weight
+            for row in range(num_rows):
+                for col in range(num_cols):
+                    i = col + row * num_cols
+                    # X links
+                    if col + 1 < num_cols:
+                        connect(node_ids[i], node_ids[i + 1],
+                                x_weight(col + 1), x_weight(col))
+                    elif x_wrap:
+                        connect(node_ids[i], node_ids[row * num_cols],
+                                x_weight(0), x_weight(col))
+                    # Y links
+                    if row + 1 < num_rows:
+                        connect(node_ids[i], node_ids[i + num_cols],
+                                y_link_weight(row + 1), y_link_weight(row))
+                    elif y_wrap:
+                        connect(node_ids[i], node_ids[col],
+                                y_link_weight(0), y_link_weight(row))
+        else:
+            fatal("Unknown inter-node fabric %s" % fabric)
+
+        return links
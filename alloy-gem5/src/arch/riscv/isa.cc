@@ -59,6 +59,7 @@
 #include "params/RiscvISA.hh"
 #include "sim/core.hh"
 #include "sim/pseudo_inst.hh"
+#include "sim/system.hh"
 
 namespace RiscvISA
 {
@@ -185,7 +186,26 @@ ISA::readMiscReg(int misc_reg, ThreadContext *tc)
       }
       case MISCREG_BARRIER_POLL:
         // DPRINTF(DOMEM, "cpu[%d] poll barrier\n", tc->getCpuPtr()->cpuId());
-        return tc->getProcessPtr()->barrierReady(tc->getCpuPtr()->cpuId());
+        return tc->getProcessPtr()->barrierReady(tc);
+      case MISCREG_DOORBELL_POLL:
+        return tc->getProcessPtr()->doorbellReady(tc);
+      case MISCREG_MWAIT_POLL:
+        return tc->getProcessPtr()->mwaitReady(tc);
+      case MISCREG_DOCNT_STNT:
+        return tc->getSystemPtr()->doCounters(tc->contextId()).stnt;
+      case MISCREG_DOCNT_STREL:
+        return tc->getSystemPtr()->doCounters(tc->contextId()).strel;
+      // the latencies are kept in ticks and read in this core's cycles,
+      // so they compare directly with rdcycle
+      case MISCREG_DOCNT_ACQ_STALL:
+        return tc->getCpuPtr()->ticksToCycles(
+            tc->getSystemPtr()->doCounters(tc->contextId()).acqStallTicks);
+      case MISCREG_DOCNT_REL_LATENCY:
+        return tc->getCpuPtr()->ticksToCycles(
+            tc->getSystemPtr()->doCounters(tc->contextId()).relLatencyTicks);
+      case MISCREG_DOCNT_BARRIER_WAIT:
+        return tc->getCpuPtr()->ticksToCycles(
+            tc->getSystemPtr()->doCounters(tc->contextId()).barrierWaitTicks);
       default:
         // Try reading HPM counters
         // As a placeholder, all HPM counters are just cycle counters
@@ -295,9 +295,26 @@ enum MiscRegIndex {
     MISCREG_STNT_END_VADDR,
     MISCREG_STREL_BEGIN_VADDR,
     MISCREG_STREL_END_VADDR,
+    MISCREG_STNT_UNREG_END_VADDR,
+    MISCREG_STREL_UNREG_END_VADDR,
     MISCREG_BARRIER_INIT,
+    MISCREG_BARRIER_ID,
+    MISCREG_BARRIER_ID_INIT,
     MISCREG_BARRIER_WAIT,
     MISCREG_BARRIER_POLL,
+    MISCREG_DOORBELL_ARM,
+    MISCREG_DOORBELL_WAIT,
+    MISCREG_DOORBELL_POLL,
+    MISCREG_MONITOR,
+    MISCREG_MWAIT,
+    MISCREG_MWAIT_POLL,
+
+    // per-hart DO event counters (read-only), see System::DOCounters
+    MISCREG_DOCNT_STNT,
+    MISCREG_DOCNT_STREL,
+    MISCREG_DOCNT_ACQ_STALL,
+    MISCREG_DOCNT_REL_LATENCY,
+    MISCREG_DOCNT_BARRIER_WAIT,
 
     // control communication from an external manager to a processor. This
     // is read- and write-enabled.
@@ -564,9 +581,24 @@ enum CSRIndex {
     CSR_STNT_END_VADDR  = 0x7D8,
     CSR_STREL_BEGIN_VADDR  = 0x7E0,
     CSR_STREL_END_VADDR  = 0x7E8,
+    CSR_STNT_UNREG_END_VADDR  = 0x7D9,
+    CSR_STREL_UNREG_END_VADDR  = 0x7E9,
     CSR_BARRIER_INIT  = 0x7F0,
+    CSR_BARRIER_ID    = 0x7F1,
+    CSR_BARRIER_ID_INIT = 0x7F2,
     CSR_BARRIER_WAIT  = 0x7F8,
     CSR_BARRIER_POLL  = 0x790,
+    CSR_DOORBELL_ARM  = 0x7C8,
+    CSR_DOORBELL_WAIT = 0x7C9,
+    CSR_DOORBELL_POLL = 0x791,
+    CSR_MONITOR       = 0x7CA,
+    CSR_MWAIT         = 0x7CB,
+    CSR_MWAIT_POLL    = 0x792,
+    CSR_DOCNT_STNT         = 0xCC0,
+    CSR_DOCNT_STREL        = 0xCC1,
+    CSR_DOCNT_ACQ_STALL    = 0xCC2,
+    CSR_DOCNT_REL_LATENCY  = 0xCC3,
+    CSR_DOCNT_BARRIER_WAIT = 0xCC4,
 
     CSR_PROC2MNGR = 0x7C0,
     CSR_MNGR2PROC = 0xFC0,
@@ -815,9 +847,24 @@ const std::map<int, CSRMetadata> CSRData = {
     {CSR_STNT_END_VADDR , { "stnt_end_vaddr"  , MISCREG_STNT_END_VADDR   }},
     {CSR_STREL_BEGIN_VADDR , { "strel_begin_vaddr"  , MISCREG_STREL_BEGIN_VADDR   }},
     {CSR_STREL_END_VADDR , { "strel_end_vaddr"  , MISCREG_STREL_END_VADDR   }},
+    {CSR_STNT_UNREG_END_VADDR , { "stnt_unreg_end_vaddr"  , MISCREG_STNT_UNREG_END_VADDR   }},
+    {CSR_STREL_UNREG_END_VADDR , { "strel_unreg_end_vaddr"  , MISCREG_STREL_UNREG_END_VADDR   }},
     {CSR_BARRIER_INIT , { "barrier_init"  , MISCREG_BARRIER_INIT   }},
+    {CSR_BARRIER_ID   , { "barrier_id"    , MISCREG_BARRIER_ID     }},
+    {CSR_BARRIER_ID_INIT, { "barrier_id_init", MISCREG_BARRIER_ID_INIT }},
     {CSR_BARRIER_WAIT , { "barrier_wait"  , MISCREG_BARRIER_WAIT   }},
     {CSR_BARRIER_POLL , { "barrier_poll"  , MISCREG_BARRIER_POLL   }},
+    {CSR_DOORBELL_ARM , { "doorbell_arm"  , MISCREG_DOORBELL_ARM   }},
+    {CSR_DOORBELL_WAIT, { "doorbell_wait" , MISCREG_DOORBELL_WAIT  }},
+    {CSR_DOORBELL_POLL, { "doorbell_poll" , MISCREG_DOORBELL_POLL  }},
+    {CSR_MONITOR      , { "monitor"       , MISCREG_MONITOR        }},
+    {CSR_MWAIT        , { "mwait"         , MISCREG_MWAIT          }},
+    {CSR_MWAIT_POLL   , { "mwait_poll"    , MISCREG_MWAIT_POLL     }},
+    {CSR_DOCNT_STNT        , { "docnt_stnt"        , MISCREG_DOCNT_STNT         }},
+    {CSR_DOCNT_STREL       , { "docnt_strel"       , MISCREG_DOCNT_STREL        }},
+    {CSR_DOCNT_ACQ_STALL   , { "docnt_acq_stall"   , MISCREG_DOCNT_ACQ_STALL    }},
+    {CSR_DOCNT_REL_LATENCY , { "docnt_rel_latency" , MISCREG_DOCNT_REL_LATENCY  }},
+    {CSR_DOCNT_BARRIER_WAIT, { "docnt_barrier_wait", MISCREG_DOCNT_BARRIER_WAIT }},
     {CSR_PROC2MNGR, { "proc2mngr" , MISCREG_PROC2MNGR  }},
     {CSR_MNGR2PROC, { "mngr2proc" , MISCREG_MNGR2PROC  }},
     {CSR_NUMCORES , { "numcores"  , MISCREG_NUMCORES   }},
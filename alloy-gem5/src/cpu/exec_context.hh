@@ -258,13 +258,44 @@ class ExecContext {
                 tcBase()->getProcessPtr()->registerSTRELEndVaddr((Addr)val, tcBase()->getCpuPtr()->cpuId());
                 DPRINTF(DOMEM, "cpu[%d] register strel end vaddr[0x%0llx]\n", tcBase()->getCpuPtr()->cpuId(), val);
                 break;
+            case TheISA::MISCREG_STNT_UNREG_END_VADDR:
+                tcBase()->getProcessPtr()->unregisterSTNTEndVaddr((Addr)val, tcBase()->getCpuPtr()->cpuId());
+                DPRINTF(DOMEM, "cpu[%d] unregister stnt end vaddr[0x%0llx]\n", tcBase()->getCpuPtr()->cpuId(), val);
+                break;
+            case TheISA::MISCREG_STREL_UNREG_END_VADDR:
+                tcBase()->getProcessPtr()->unregisterSTRELEndVaddr((Addr)val, tcBase()->getCpuPtr()->cpuId());
+                DPRINTF(DOMEM, "cpu[%d] unregister strel end vaddr[0x%0llx]\n", tcBase()->getCpuPtr()->cpuId(), val);
+                break;
             case TheISA::MISCREG_BARRIER_INIT:
                 tcBase()->getProcessPtr()->barrierInit(val);
                 DPRINTF(DOMEM, "cpu[%d] init barrier\n", tcBase()->getCpuPtr()->cpuId());
                 break;
+            case TheISA::MISCREG_BARRIER_ID:
+                tcBase()->getProcessPtr()->registerBarrierId(val, tcBase()->getCpuPtr()->cpuId());
+                break;
+            case TheISA::MISCREG_BARRIER_ID_INIT:
+                tcBase()->getProcessPtr()->barrierInitId(val, tcBase()->getCpuPtr()->cpuId());
+                DPRINTF(DOMEM, "cpu[%d] init barrier[%d]\n", tcBase()->getCpuPtr()->cpuId(), val);
+                break;
             case TheISA::MISCREG_BARRIER_WAIT:
-                tcBase()->getProcessPtr()->barrierWait(val);
-                DPRINTF(DOMEM, "cpu[%d] wait barrier\n", tcBase()->getCpuPtr()->cpuId());
+                DPRINTF(DOMEM, "cpu[%d] wait barrier[%d]\n", tcBase()->getCpuPtr()->cpuId(), val);
+                tcBase()->getProcessPtr()->barrierWait(val, tcBase());
+                break;
+            case TheISA::MISCREG_DOORBELL_ARM:
+                DPRINTF(DOMEM, "cpu[%d] arm doorbell vaddr[0x%0llx]\n", tcBase()->getCpuPtr()->cpuId(), val);
+                tcBase()->getProcessPtr()->doorbellArm((Addr)val, tcBase());
+                break;
+            case TheISA::MISCREG_DOORBELL_WAIT:
+                DPRINTF(DOMEM, "cpu[%d] wait doorbell\n", tcBase()->getCpuPtr()->cpuId());
+                tcBase()->getProcessPtr()->doorbellWait(tcBase());
+                break;
+            case TheISA::MISCREG_MONITOR:
+                DPRINTF(DOMEM, "cpu[%d] monitor vaddr[0x%0llx]\n", tcBase()->getCpuPtr()->cpuId(), val);
+                tcBase()->getProcessPtr()->monitorArm((Addr)val, tcBase());
+                break;
+            case TheISA::MISCREG_MWAIT:
+                DPRINTF(DOMEM, "cpu[%d] mwait timeout[%d]\n", tcBase()->getCpuPtr()->cpuId(), val);
+                tcBase()->getProcessPtr()->mwait(Cycles(val), tcBase());
                 break;
             case TheISA::MISCREG_STATS_EN:
                 if (old_val == 0 && val == 1) {
@@ -286,8 +317,12 @@ class ExecContext {
 
                     // entering a timing region, we need to switch from
                     // a CPU model used to warm up to a detailed timing model.
-                    if (tcBase()->getSystemPtr()->brg_fast_forward)
+                    System *sys = tcBase()->getSystemPtr();
+                    if (sys->brg_fast_forward &&
+                        sys->brg_roi_phase == System::BrgROIPhase::Before) {
+                        sys->brg_roi_phase = System::BrgROIPhase::Inside;
                         PseudoInst::switchcpu(tcBase());
+                    }
 
                     // on stats enable, make sure stats on all processors
                     // are initialized
@@ -320,8 +355,12 @@ class ExecContext {
 
                     // exiting a timing region, we need to switch from
                     // the detailed timing model to an atomic CPU model.
-                    if (tcBase()->getSystemPtr()->brg_fast_forward)
+                    System *sys = tcBase()->getSystemPtr();
+                    if (sys->brg_fast_forward &&
+                        sys->brg_roi_phase == System::BrgROIPhase::Inside) {
+                        sys->brg_roi_phase = System::BrgROIPhase::After;
                         PseudoInst::switchcpu(tcBase());
+                    }
 
                     tcBase()->getCpuPtr()->global_stats_en = false;
                     std::vector<BaseCPU*> cpuList
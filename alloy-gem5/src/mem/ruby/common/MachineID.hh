@@ -47,6 +47,7 @@
 #include <functional>
 
 #include "base/cprintf.hh"
+#include "base/logging.hh"
 #include "mem/protocol/MachineType.hh"
 
 struct MachineID
@@ -69,6 +70,19 @@ MachineIDToString(MachineID machine)
     return csprintf("%s_%d", MachineType_to_string(machine.type), machine.num);
 }
 
+// Checkpoints record a machine by type name rather than enum value, so
+// that they restore into a differently configured Ruby system, as long as
+// the machine still exists there.
+inline MachineID
+checkpointedMachineID(const std::string &type, NodeID num)
+{
+    MachineID machine(string_to_MachineType(type), num);
+    fatal_if(num >= MachineType_base_count(machine.type),
+             "checkpointed machine %s does not exist in this system\n",
+             MachineIDToString(machine));
+    return machine;
+}
+
 inline bool
 operator==(const MachineID & obj1, const MachineID & obj2)
 {
@@ -0,0 +1,166 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: LicenseRef-NvidiaProprietary
+ *
+ * NVIDIA CORPORATION, its affiliates and licensors retain all intellectual
+ * property and proprietary rights in and to this material, related
+ * documentation and any modifications thereto. Any use, reproduction,
+ * disclosure or distribution of this material and related documentation
+ * without an express license agreement from NVIDIA CORPORATION or
+ * its affiliates is strictly prohibited.
+ */
+
+#ifndef __MEM_RUBY_COMMON_SPARSEDATABLOCK_HH__
+#define __MEM_RUBY_COMMON_SPARSEDATABLOCK_HH__
+
+#include <cassert>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "mem/packet.hh"
+#include "mem/ruby/common/Address.hh"
+#include "mem/ruby/common/DataBlock.hh"
+#include "mem/ruby/common/WriteMask.hh"
+#include "mem/ruby/system/RubySystem.hh"
+
+// Payload of the DO store messages (PUT_NT / PUT_REL). Instead of a full
+// DataBlock it keeps only the span [offset, offset + len) of the line that
+// the write mask covers, plus the mask itself, so the common word-sized
+// store copies 16 inline bytes through the MessageBuffers and the NI.
+// Spans longer than INLINE_BYTES (coalesced stores) spill to the heap.
+class SparseDataBlock
+{
+  public:
+    static const int INLINE_BYTES = 16;
+
+    SparseDataBlock() : m_offset(0), m_len(0), m_mask(0) {}
+
+    // Capture the bytes of blk selected by mask
+    void
+    setFrom(const DataBlock &blk, const WriteMask &mask)
+    {
+        int first = -1, last = -1;
+        for (int i = 0; i < RubySystem::getBlockSizeBytes(); i++) {
+            if (mask.test(i)) {
+                if (first == -1)
+                    first = i;
+                last = i;
+            }
+        }
+
+        m_overflow.clear();
+        m_mask = 0;
+        if (first == -1) {
+            m_offset = m_len = 0;
+            return;
+        }
+
+        // the mask is kept as a bit per byte of the line
+        assert(RubySystem::getBlockSizeBytes() <= 64);
+        m_offset = first;
+        m_len = last - first + 1;
+        for (int i = first; i <= last; i++) {
+            if (mask.test(i))
+                m_mask |= (uint64_t)1 << i;
+        }
+
+        if (m_len > INLINE_BYTES)
+            m_overflow.resize(m_len);
+        memcpy(data(), blk.getData(m_offset, m_len), m_len);
+    }
+
+    // Merge the written bytes into blk
+    void
+    applyTo(DataBlock &blk) const
+    {
+        for (int i = 0; i < m_len; i++) {
+            if (isWritten(m_offset + i))
+                blk.setByte(m_offset + i, data()[i]);
+        }
+    }
+
+    bool isEmpty() const { return m_len == 0; }
+    int getOffset() const { return m_offset; }
+    int getLength() const { return m_len; }
+    bool
+    isWritten(int line_offset) const
+    {
+        return line_offset < 64 && (m_mask >> line_offset) & 1;
+    }
+
+    uint8_t *data() { return m_len > INLINE_BYTES ?
+                      m_overflow.data() : m_inline; }
+    const uint8_t *data() const { return m_len > INLINE_BYTES ?
+                                  m_overflow.data() : m_inline; }
+
+    void
+    print(std::ostream& out) const
+    {
+        out << "[ off " << (int)m_offset << " len " << (int)m_len << " ";
+        for (int i = 0; i < m_len; i++) {
+            out << std::setw(2) << std::setfill('0') << std::hex
+                << "0x" << (int)data()[i] << " " << std::setfill(' ');
+        }
+        out << std::dec << "]" << std::flush;
+    }
+
+  private:
+    uint8_t m_offset;
+    uint8_t m_len;
+    uint64_t m_mask;
+    uint8_t m_inline[INLINE_BYTES];
+    std::vector<uint8_t> m_overflow;
+};
+
+inline std::ostream&
+operator<<(std::ostream& out, const SparseDataBlock& obj)
+{
+    obj.print(out);
+    out << std::flush;
+    return out;
+}
+
+// Functional accesses: only the written bytes of the line are present in a
+// sparse payload, so a read hits only if it is fully covered by them.
+inline bool
+testAndReadSparse(Addr addr, const SparseDataBlock &blk, Packet *pkt)
+{
+    Addr pktLineAddr = makeLineAddress(pkt->getAddr());
+    Addr lineAddr = makeLineAddress(addr);
+    if (pktLineAddr != lineAddr)
+        return false;
+
+    int offset = getOffset(pkt->getAddr());
+    for (int i = 0; i < pkt->getSize(); i++) {
+        if (!blk.isWritten(offset + i))
+            return false;
+    }
+
+    memcpy(pkt->getPtr<uint8_t>(),
+           blk.data() + (offset - blk.getOffset()), pkt->getSize());
+    return true;
+}
+
+inline bool
+testAndWriteSparse(Addr addr, SparseDataBlock &blk, Packet *pkt)
+{
+    Addr pktLineAddr = makeLineAddress(pkt->getAddr());
+    Addr lineAddr = makeLineAddress(addr);
+    if (pktLineAddr != lineAddr)
+        return false;
+
+    bool written = false;
+    int offset = getOffset(pkt->getAddr());
+    const uint8_t *pkt_data = pkt->getConstPtr<uint8_t>();
+    for (int i = 0; i < pkt->getSize(); i++) {
+        if (blk.isWritten(offset + i)) {
+            blk.data()[offset + i - blk.getOffset()] = pkt_data[i];
+            written = true;
+        }
+    }
+    return written;
+}
+
+#endif // __MEM_RUBY_COMMON_SPARSEDATABLOCK_HH__
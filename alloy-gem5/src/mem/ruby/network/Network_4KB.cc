@@ -166,6 +166,7 @@ Network::MessageSizeType_to_int(MessageSizeType size_type)
       case MessageSizeType_Completion_Control:
       case MessageSizeType_REQ_NOTIFY:
       case MessageSizeType_NOTIFY:
+      case MessageSizeType_DOORBELL:
       case MessageSizeType_PUT_REL_ACK:
         return m_control_msg_size;
       case MessageSizeType_Data:
@@ -57,8 +57,10 @@
 #include "mem/ruby/network/garnet2.0/GarnetLink.hh"
 #include "mem/ruby/network/garnet2.0/NetworkInterface.hh"
 #include "mem/ruby/network/garnet2.0/NetworkLink.hh"
+#include "mem/ruby/network/garnet2.0/OutputUnit.hh"
 #include "mem/ruby/network/garnet2.0/Router.hh"
 #include "mem/ruby/system/RubySystem.hh"
+#include "sim/stats.hh"
 #include "debug/RRC.hh"
 
 using namespace std;
@@ -102,6 +104,8 @@ GarnetNetwork::GarnetNetwork(const Params *p)
         // initialize the router's network pointers
         router->init_net_ptr(this);
     }
+    m_route_table.resize(m_routers.size());
+    m_route_weight.resize(m_routers.size());
 
     // record the network interfaces
     for (vector<ClockedObject*>::const_iterator i = p->netifs.begin();
@@ -163,6 +167,8 @@ GarnetNetwork::~GarnetNetwork()
     deletePointers(m_nis);
     deletePointers(m_networklinks);
     deletePointers(m_creditlinks);
+    deletePointers(m_msg_network_latency_hist);
+    deletePointers(m_msg_queueing_latency_hist);
 }
 
 /*
@@ -218,6 +224,7 @@ GarnetNetwork::makeExtOutLink(SwitchID src, NodeID dest, BasicLink* link,
     m_creditlinks.push_back(credit_link);
 
     PortDirection src_outport_dirn = "Local";
+    addRouteEntry(src, routing_table_entry, link->m_weight);
     m_routers[src]->addOutPort(src_outport_dirn, net_link,
                                routing_table_entry,
                                link->m_weight, credit_link);
@@ -246,11 +253,96 @@ GarnetNetwork::makeInternalLink(SwitchID src, SwitchID dest, BasicLink* link,
     m_creditlinks.push_back(credit_link);
 
     m_routers[dest]->addInPort(dst_inport_dirn, net_link, credit_link);
+    addRouteEntry(src, routing_table_entry, link->m_weight);
     m_routers[src]->addOutPort(src_outport_dirn, net_link,
                                routing_table_entry,
                                link->m_weight, credit_link);
 }
 
+/*
+ * Outports are added to a router in the same order as its routing table
+ * entries, so the index into m_route_table[router] is the outport id.
+ */
+
+void
+GarnetNetwork::addRouteEntry(SwitchID router,
+                             const NetDest& routing_table_entry,
+                             int link_weight)
+{
+    assert(router < m_route_table.size());
+    m_route_table[router].push_back(routing_table_entry);
+    m_route_weight[router].push_back(link_weight);
+}
+
+/*
+ * Adaptive routing (--routing-algorithm 3).
+ * The candidates are the minimal-weight outports that reach the
+ * destination, i.e. the same set TABLE_ routing picks from. Among them the
+ * outport with the most free downstream buffers wins. The lowest-numbered
+ * candidate is the default outport: it is used for ordered vnets (which
+ * must not be reordered) and whenever no candidate has a free buffer.
+ *
+ * There are no escape VCs: reserving one per vnet needs the VC allocator
+ * (OutputUnit, SwitchAllocator), which is not part of this tree. Deadlock
+ * freedom comes from the link weights alone: every candidate lies
+ * on a minimal-weight route, and the topology must pick weights under which
+ * the union of those routes has no cyclic channel dependency (dimension
+ * order plus a dateline router per ring, see TwoMeshXY.py). Any choice
+ * among the candidates is then as safe as the one TABLE_ routing makes.
+ */
+
+int
+GarnetNetwork::outportComputeAdaptive(Router *router, RouteInfo route)
+{
+    int router_id = router->get_id();
+    std::vector<NetDest> &table = m_route_table[router_id];
+    std::vector<int> &weights = m_route_weight[router_id];
+
+    int min_weight = INFINITE_;
+    for (int link = 0; link < table.size(); link++) {
+        if (route.net_dest.intersectionIsNotEmpty(table[link]) &&
+            weights[link] < min_weight) {
+            min_weight = weights[link];
+        }
+    }
+
+    int default_outport = -1;
+    int best_outport = -1;
+    int best_credits = 0;
+    std::vector<OutputUnit *> &output_units = router->get_outputUnit_ref();
+    int vc_base = route.vnet * m_vcs_per_vnet;
+    for (int link = 0; link < table.size(); link++) {
+        if (weights[link] != min_weight ||
+            !route.net_dest.intersectionIsNotEmpty(table[link])) {
+            continue;
+        }
+
+        if (default_outport == -1) {
+            default_outport = link;
+            if (isVNetOrdered(route.vnet))
+                break;
+        }
+
+        int credits = 0;
+        for (int vc = vc_base; vc < vc_base + m_vcs_per_vnet; vc++) {
+            credits += output_units[link]->get_credit_count(vc);
+        }
+        if (credits > best_credits) {
+            best_credits = credits;
+            best_outport = link;
+        }
+    }
+
+    assert(default_outport != -1);
+    if (best_outport == -1) {
+        increment_blocked_routes();
+        return default_outport;
+    }
+    if (best_outport != default_outport)
+        increment_adaptive_reroutes();
+    return best_outport;
+}
+
 // Total routers in the network
 int
 GarnetNetwork::getNumRouters()
@@ -329,6 +421,24 @@ GarnetNetwork::regStats()
     m_avg_packet_latency
         = m_avg_packet_network_latency + m_avg_packet_queueing_latency;
 
+    for (int i = 0; i < MessageSizeType_NUM; i++) {
+        std::string type = MessageSizeType_to_string((MessageSizeType) i);
+
+        m_msg_network_latency_hist.push_back(new Stats::Histogram());
+        m_msg_network_latency_hist[i]
+            ->init(10)
+            .name(name() + ".msg_network_latency." + type)
+            .desc("packet network latency of " + type + " messages")
+            .flags(Stats::nozero | Stats::pdf);
+
+        m_msg_queueing_latency_hist.push_back(new Stats::Histogram());
+        m_msg_queueing_latency_hist[i]
+            ->init(10)
+            .name(name() + ".msg_queueing_latency." + type)
+            .desc("packet queueing latency of " + type + " messages")
+            .flags(Stats::nozero | Stats::pdf);
+    }
+
     // Flits
     m_flits_received
         .init(m_virtual_networks)
@@ -392,6 +502,31 @@ GarnetNetwork::regStats()
     m_avg_hops.name(name() + ".average_hops");
     m_avg_hops = m_total_hops / sum(m_flits_received);
 
+    // Adaptive routing
+    m_adaptive_reroutes
+        .name(name() + ".adaptive_reroutes")
+        .desc("head flits routed off the deterministic outport");
+    m_blocked_routes
+        .name(name() + ".blocked_routes")
+        .desc("head flits routed on the default outport (no free buffers)");
+
+    // Simulator activity
+    m_router_wakeups
+        .name(name() + ".router_wakeups")
+        .desc("router wakeups, counted at inport 0 of each router");
+    m_ni_wakeups
+        .name(name() + ".ni_wakeups")
+        .desc("network interface wakeup events");
+    m_link_wakeups
+        .name(name() + ".link_wakeups")
+        .desc("network and credit link wakeup events");
+    m_host_events_per_cycle
+        .name(name() + ".host_events_per_cycle")
+        .desc("router, NI and link wakeups per simulated network cycle");
+    m_host_events_per_cycle =
+        (m_router_wakeups + m_ni_wakeups + m_link_wakeups) /
+        (simTicks / Stats::constant(clockPeriod()));
+
     // Links
     m_total_ext_in_link_utilization
         .name(name() + ".ext_in_link_utilization");
@@ -443,6 +578,12 @@ GarnetNetwork::collateStats()
             m_total_CG_link_flits_bytes += m_networklinks[i]->getLinkFlitBytes();
             m_total_CG_link_flits_count += m_networklinks[i]->getLinkFlitCount();
         }
+
+        m_link_wakeups += m_networklinks[i]->getLinkWakeups();
+    }
+
+    for (int i = 0; i < m_creditlinks.size(); i++) {
+        m_link_wakeups += m_creditlinks[i]->getLinkWakeups();
     }
 
     // Ask the routers to collate their statistics
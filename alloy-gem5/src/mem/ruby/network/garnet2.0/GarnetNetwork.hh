@@ -48,12 +48,14 @@
 #define __MEM_RUBY_NETWORK_GARNET2_0_GARNETNETWORK_HH__
 
 #include <iostream>
+#include <mutex>
 #include <vector>
 
 #include "mem/ruby/network/Network.hh"
 #include "mem/ruby/network/fault_model/FaultModel.hh"
 #include "mem/ruby/network/garnet2.0/CommonTypes.hh"
 #include "params/GarnetNetwork.hh"
+#include "sim/eventq.hh"
 
 class FaultModel;
 class NetworkInterface;
@@ -83,6 +85,8 @@ class GarnetNetwork : public Network
     uint32_t getBuffersPerDataVC() { return m_buffers_per_data_vc; }
     uint32_t getBuffersPerCtrlVC() { return m_buffers_per_ctrl_vc; }
     int getRoutingAlgorithm() const { return m_routing_algorithm; }
+    bool isAdaptiveRouting() const
+    { return m_routing_algorithm == ADAPTIVE_ROUTING_; }
 
     bool isFaultModelEnabled() const { return m_enable_fault_model; }
     FaultModel* fault_model;
@@ -99,6 +103,11 @@ class GarnetNetwork : public Network
     int getNumRouters();
     int get_router_id(int ni);
 
+    // Adaptive routing: pick the least congested of the minimal-weight
+    // outports towards the destination. Falls back to the lowest-numbered
+    // (default) outport when no candidate has a free buffer.
+    int outportComputeAdaptive(Router *router, RouteInfo route);
+
 
     // Methods used by Topology to setup the network
     void makeExtOutLink(SwitchID src, NodeID dest, BasicLink* link,
@@ -120,43 +129,117 @@ class GarnetNetwork : public Network
     void regStats();
     void print(std::ostream& out) const;
 
+    // Routers and NIs of different nodes may run on different event queues
+    // (--parallel-nodes) and update the network-wide counters below from
+    // their own host threads. Serial runs skip the lock.
+    std::unique_lock<std::mutex>
+    statsLock()
+    {
+        return numMainEventQueues > 1 ?
+            std::unique_lock<std::mutex>(m_stats_mutex) :
+            std::unique_lock<std::mutex>();
+    }
+
     // increment counters
-    void increment_injected_packets(int vnet) { m_packets_injected[vnet]++; }
-    void increment_received_packets(int vnet) { m_packets_received[vnet]++; }
+    void
+    increment_injected_packets(int vnet)
+    {
+        auto lock = statsLock();
+        m_packets_injected[vnet]++;
+    }
+    void
+    increment_received_packets(int vnet)
+    {
+        auto lock = statsLock();
+        m_packets_received[vnet]++;
+    }
 
     void
     increment_packet_network_latency(Cycles latency, int vnet)
     {
+        auto lock = statsLock();
         m_packet_network_latency[vnet] += latency;
     }
 
     void
     increment_packet_queueing_latency(Cycles latency, int vnet)
     {
+        auto lock = statsLock();
         m_packet_queueing_latency[vnet] += latency;
     }
 
-    void increment_injected_flits(int vnet) { m_flits_injected[vnet]++; }
-    void increment_received_flits(int vnet) { m_flits_received[vnet]++; }
+    void
+    increment_injected_flits(int vnet)
+    {
+        auto lock = statsLock();
+        m_flits_injected[vnet]++;
+    }
+    void
+    increment_received_flits(int vnet)
+    {
+        auto lock = statsLock();
+        m_flits_received[vnet]++;
+    }
 
     void
     increment_flit_network_latency(Cycles latency, int vnet)
     {
+        auto lock = statsLock();
         m_flit_network_latency[vnet] += latency;
     }
 
     void
     increment_flit_queueing_latency(Cycles latency, int vnet)
     {
+        auto lock = statsLock();
         m_flit_queueing_latency[vnet] += latency;
     }
 
+    // Per message type (MessageSizeType) packet latency. The DO messages
+    // (PUT_NT, PUT_REL, REQ_NOTIFY, NOTIFY, PUT_REL_ACK) each have their
+    // own size type but share vnets with other traffic.
+    void
+    sample_msg_latency(MessageSizeType type, Cycles network_latency,
+                       Cycles queueing_latency)
+    {
+        auto lock = statsLock();
+        m_msg_network_latency_hist[type]->sample(network_latency);
+        m_msg_queueing_latency_hist[type]->sample(queueing_latency);
+    }
+
     void
     increment_total_hops(int hops)
     {
+        auto lock = statsLock();
         m_total_hops += hops;
     }
 
+    void
+    increment_adaptive_reroutes()
+    {
+        auto lock = statsLock();
+        m_adaptive_reroutes++;
+    }
+
+    void
+    increment_router_wakeups()
+    {
+        auto lock = statsLock();
+        m_router_wakeups++;
+    }
+    void
+    increment_ni_wakeups()
+    {
+        auto lock = statsLock();
+        m_ni_wakeups++;
+    }
+    void
+    increment_blocked_routes()
+    {
+        auto lock = statsLock();
+        m_blocked_routes++;
+    }
+
   protected:
     // Configuration
     int m_num_rows;
@@ -180,6 +263,9 @@ class GarnetNetwork : public Network
     Stats::Formula m_avg_packet_queueing_latency;
     Stats::Formula m_avg_packet_latency;
 
+    std::vector<Stats::Histogram *> m_msg_network_latency_hist;
+    std::vector<Stats::Histogram *> m_msg_queueing_latency_hist;
+
     Stats::Vector m_flits_received;
     Stats::Vector m_flits_injected;
     Stats::Vector m_flit_network_latency;
@@ -202,15 +288,38 @@ class GarnetNetwork : public Network
     Stats::Scalar  m_total_hops;
     Stats::Formula m_avg_hops;
 
+    // adaptive routing
+    Stats::Scalar m_adaptive_reroutes;
+    Stats::Scalar m_blocked_routes;
+
+    // Host events (component wakeups) per simulated network cycle
+    Stats::Scalar m_router_wakeups;
+    Stats::Scalar m_ni_wakeups;
+    Stats::Scalar m_link_wakeups;
+    Stats::Formula m_host_events_per_cycle;
+
   private:
     GarnetNetwork(const GarnetNetwork& obj);
     GarnetNetwork& operator=(const GarnetNetwork& obj);
 
+    // --routing-algorithm value selecting outportComputeAdaptive()
+    static const int ADAPTIVE_ROUTING_ = 3;
+
+    // Mirror of each router's routing table, in outport order, so that
+    // adaptive routing can enumerate the candidate outports.
+    void addRouteEntry(SwitchID router, const NetDest& routing_table_entry,
+                       int link_weight);
+    std::vector<std::vector<NetDest> > m_route_table;
+    std::vector<std::vector<int> > m_route_weight;
+
     std::vector<VNET_type > m_vnet_type;
     std::vector<Router *> m_routers;   // All Routers in Network
     std::vector<NetworkLink *> m_networklinks; // All flit links in the network
     std::vector<CreditLink *> m_creditlinks; // All credit links in the network
     std::vector<NetworkInterface *> m_nis;   // All NI's in Network
+
+    // see statsLock()
+    std::mutex m_stats_mutex;
 };
 
 inline std::ostream&
@@ -49,6 +49,7 @@
 #include "base/stl_helpers.hh"
 #include "debug/RubyNetwork.hh"
 #include "mem/ruby/network/garnet2.0/Credit.hh"
+#include "mem/ruby/network/garnet2.0/GarnetNetwork.hh"
 #include "mem/ruby/network/garnet2.0/Router.hh"
 
 using namespace std;
@@ -97,6 +98,12 @@ InputUnit::~InputUnit()
 void
 InputUnit::wakeup()
 {
+    // Router::wakeup() visits every inport once, so inport 0 sees each
+    // router wakeup exactly once. This only counts wakeups: when a router
+    // is scheduled is decided in Router.cc, which is not part of this tree.
+    if (m_id == 0)
+        m_router->get_net_ptr()->increment_router_wakeups();
+
     flit *t_flit;
     if (m_in_link->isReady(m_router->curCycle())) {
 
@@ -115,8 +122,18 @@ InputUnit::wakeup()
             set_vc_active(vc, m_router->curCycle());
 
             // Route computation for this vc
-            int outport = m_router->route_compute(t_flit->get_route(),
-                m_id, m_direction);
+            // Ejection always goes through the routing table since several
+            // NIs may share the "Local" direction of the destination router
+            int outport;
+            GarnetNetwork *net_ptr = m_router->get_net_ptr();
+            if (net_ptr->isAdaptiveRouting() &&
+                t_flit->get_route().dest_router != m_router->get_id()) {
+                outport = net_ptr->outportComputeAdaptive(m_router,
+                    t_flit->get_route());
+            } else {
+                outport = m_router->route_compute(t_flit->get_route(),
+                    m_id, m_direction);
+            }
 
             // Update output port in VC
             // All flits in this packet will use this output port
@@ -138,6 +138,10 @@ NetworkInterface::addNode(vector<MessageBuffer *>& in,
     for (auto& it : in) {
         if (it != nullptr) {
             it->setConsumer(this);
+            // --parallel-nodes places an NI with its controller
+            fatal_if(it->eventQueue() != eventQueue(),
+                     "%s and %s are on different event queues\n",
+                     name(), it->name());
         }
     }
 }
@@ -172,6 +176,9 @@ NetworkInterface::incrementStats(flit *t_flit)
         m_net_ptr->increment_received_packets(vnet);
         m_net_ptr->increment_packet_network_latency(network_delay, vnet);
         m_net_ptr->increment_packet_queueing_latency(queueing_delay, vnet);
+        m_net_ptr->sample_msg_latency(
+            t_flit->get_msg_ptr()->getMessageSize(), network_delay,
+            queueing_delay);
     }
 
     // Hops
@@ -194,6 +201,8 @@ NetworkInterface::wakeup()
     DPRINTF(RubyNetwork, "Network Interface %d connected to router %d "
             "woke up at time: %lld\n", m_id, m_router_id, curCycle());
 
+    m_net_ptr->increment_ni_wakeups();
+
     MsgPtr msg_ptr;
     Tick curTime = clockEdge();
 
@@ -267,11 +276,20 @@ NetworkInterface::wakeup()
 
     if (inCreditLink->isReady(curCycle())) {
         Credit *t_credit = (Credit*) inCreditLink->consumeLink();
-        m_out_vc_state[t_credit->get_vc()]->increment_credit();
+        int vc = t_credit->get_vc();
+        m_out_vc_state[vc]->increment_credit();
         if (t_credit->is_free_signal()) {
-            m_out_vc_state[t_credit->get_vc()]->setState(IDLE_, curCycle());
+            m_out_vc_state[vc]->setState(IDLE_, curCycle());
         }
         delete t_credit;
+
+        // checkReschedule() does not poll VCs blocked on credits, or vnets
+        // blocked on a free VC, so the credit is what unblocks them.
+        MessageBuffer *b = inNode_ptr[get_vnet(vc)];
+        if (m_ni_out_vcs[vc]->isReady(curCycle() + Cycles(1)) ||
+            (b != nullptr && b->isReady(clockEdge(Cycles(1))))) {
+            scheduleEvent(Cycles(1));
+        }
     }
 
 
@@ -358,6 +376,16 @@ NetworkInterface::flitisizeMessage(MsgPtr msg_ptr, int vnet)
         int vc = calculateVC(vnet);
 
         if (vc == -1) {
+            // A blocked vnet is retried only when a credit arrives, so the
+            // deadlock check goes by how long the message has waited, and a
+            // wakeup is set for when it crosses the threshold in case no
+            // credit ever comes.
+            Cycles waited = curCycle() -
+                ticksToCycles(msg_ptr->getLastEnqueueTime());
+            panic_if(waited > m_deadlock_threshold,
+                "%s: Possible network deadlock in vnet: %d at time: %llu \n",
+                name(), vnet, curTick());
+            scheduleEvent(Cycles(m_deadlock_threshold + 1 - waited));
             return false ;
         }
         MsgPtr new_msg_ptr = msg_ptr->clone();
@@ -440,10 +468,8 @@ NetworkInterface::calculateVC(int vnet)
         }
     }
 
+    // the vnet is blocked until a credit frees a VC, see flitisizeMessage()
     vc_busy_counter[vnet] += 1;
-    panic_if(vc_busy_counter[vnet] > m_deadlock_threshold,
-        "%s: Possible network deadlock in vnet: %d at time: %llu \n",
-        name(), vnet, curTick());
 
     return -1;
 }
@@ -523,23 +549,28 @@ NetworkInterface::get_vnet(int vc)
 
 // Wakeup the NI in the next cycle if there are waiting
 // messages in the protocol buffer, or waiting flits in the
-// output VC buffer
+// output VC buffer.
+// A vnet whose last flitisize failed for lack of a free VC, and an output
+// VC without credits, cannot make progress until a credit arrives. The
+// credit link wakes the NI for that, so neither is polled here.
 void
 NetworkInterface::checkReschedule()
 {
-    for (const auto& it : inNode_ptr) {
-        if (it == nullptr) {
+    for (int vnet = 0; vnet < inNode_ptr.size(); ++vnet) {
+        MessageBuffer *b = inNode_ptr[vnet];
+        if (b == nullptr || vc_busy_counter[vnet] > 0) {
             continue;
         }
 
-        while (it->isReady(clockEdge())) { // Is there a message waiting
+        if (b->isReady(clockEdge())) { // Is there a message waiting
             scheduleEvent(Cycles(1));
             return;
         }
     }
 
     for (int vc = 0; vc < m_num_vcs; vc++) {
-        if (m_ni_out_vcs[vc]->isReady(curCycle() + Cycles(1))) {
+        if (m_ni_out_vcs[vc]->isReady(curCycle() + Cycles(1)) &&
+            m_out_vc_state[vc]->has_credit()) {
             scheduleEvent(Cycles(1));
             return;
         }
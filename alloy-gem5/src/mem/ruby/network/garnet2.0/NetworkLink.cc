@@ -46,6 +46,9 @@
 
 #include "mem/ruby/network/garnet2.0/NetworkLink.hh"
 
+#include <algorithm>
+#include <cmath>
+
 #include "mem/ruby/network/garnet2.0/CreditLink.hh"
 
 
@@ -53,10 +56,32 @@ NetworkLink::NetworkLink(const Params *p)
     : ClockedObject(p), Consumer(this), m_id(p->link_id),
       m_type(NUM_LINK_TYPES_),
       m_latency(p->link_latency),
+      m_serialization_latency(p->serialization_latency),
+      m_bandwidth(p->link_bandwidth), m_flit_wire_bytes(0),
+      m_credit_cap(0), m_byte_credits(0), m_credit_cycle(0),
+      m_flit_transfer(0),
       linkBuffer(new flitBuffer()), link_consumer(nullptr),
-      link_srcQueue(nullptr), m_link_utilized(0),
-      m_vc_load(p->vcs_per_vnet * p->virt_nets)
+      link_srcQueue(nullptr), m_consumer_eventq(nullptr), m_link_utilized(0),
+      m_vc_load(p->vcs_per_vnet * p->virt_nets),
+      m_link_flit_bytes(0), m_link_flit_count(0), m_link_wakeups(0)
 {
+    if (m_bandwidth > 0) {
+        // Network flits smaller than a link flit share it; larger ones
+        // take whole link flits. Every link flit carries the overhead.
+        uint32_t payload = p->link_flit_size > 0 ?
+            p->link_flit_size : p->ni_flit_size;
+        uint32_t carried = p->ni_flit_size <= payload ? p->ni_flit_size :
+            payload * ((p->ni_flit_size + payload - 1) / payload);
+        m_flit_wire_bytes = carried *
+            (double)(payload + p->link_flit_overhead) / payload;
+        // Room for one flit plus a cycle's worth, so no credit is lost
+        // while flits are waiting. An idle link can then send two flits
+        // back to back.
+        m_credit_cap = m_flit_wire_bytes + m_bandwidth;
+        m_byte_credits = m_credit_cap;
+        m_flit_transfer = Cycles(std::ceil(m_flit_wire_bytes / m_bandwidth)
+                                 - 1);
+    }
 }
 
 NetworkLink::~NetworkLink()
@@ -68,6 +93,8 @@ void
 NetworkLink::setLinkConsumer(Consumer *consumer)
 {
     link_consumer = consumer;
+    ClockedObject *obj = dynamic_cast<ClockedObject *>(consumer);
+    m_consumer_eventq = obj ? obj->eventQueue() : eventQueue();
 }
 
 void
@@ -79,11 +106,48 @@ NetworkLink::setSourceQueue(flitBuffer *srcQueue)
 void
 NetworkLink::wakeup()
 {
+    m_link_wakeups++;
+
+    if (m_bandwidth > 0) {
+        m_byte_credits = std::min(m_credit_cap, m_byte_credits +
+            m_bandwidth * (double)(curCycle() - m_credit_cycle));
+        m_credit_cycle = curCycle();
+
+        // Not enough byte credits for the next flit yet. It waits in the
+        // upstream output buffer, holding its VC credits.
+        if (link_srcQueue->isReady(curCycle()) &&
+            m_byte_credits < m_flit_wire_bytes) {
+            scheduleEventAbsolute(clockEdge(Cycles(std::ceil(
+                (m_flit_wire_bytes - m_byte_credits) / m_bandwidth))));
+            return;
+        }
+    }
+
     if (link_srcQueue->isReady(curCycle())) {
         flit *t_flit = link_srcQueue->getTopFlit();
-        t_flit->set_time(curCycle() + m_latency);
-        linkBuffer->insert(t_flit);
-        link_consumer->scheduleEventAbsolute(clockEdge(m_latency));
+        m_byte_credits -= m_flit_wire_bytes;
+        Cycles delay = m_latency + m_serialization_latency + m_flit_transfer;
+        t_flit->set_time(curCycle() + delay);
+        if (m_consumer_eventq == eventQueue()) {
+            linkBuffer->insert(t_flit);
+            link_consumer->scheduleEventAbsolute(clockEdge(delay));
+        } else {
+            // The consumer runs on another host thread. Only touch the
+            // link buffer from the consumer's queue; the link latency
+            // covers the simulation quantum (see configs/brg/sc3.py).
+            // Deliver ahead of the consumer's own events at that tick,
+            // as if the flit had been in the buffer since it was sent.
+            Tick when = clockEdge(delay);
+            m_consumer_eventq->schedule(new EventFunctionWrapper(
+                [this, t_flit, when] {
+                    linkBuffer->insert(t_flit);
+                    link_consumer->scheduleEventAbsolute(when);
+                }, name() + ".handoff", true, Event::Default_Pri - 1),
+                when);
+        }
+        if (m_bandwidth > 0 && link_srcQueue->isReady(curCycle() + Cycles(1))) {
+            scheduleEventAbsolute(clockEdge(Cycles(1)));
+        }
         m_link_utilized++;
         m_vc_load[t_flit->get_vc()]++;
 
@@ -109,6 +173,7 @@ NetworkLink::resetStats()
     }
 
     m_link_utilized = 0;
+    m_link_wakeups = 0;
 }
 
 NetworkLink *
@@ -90,15 +90,31 @@ class NetworkLink : public ClockedObject, public Consumer
     bool isCGLink() { return m_latency >= (Cycles)25; }
     uint64_t getLinkFlitBytes() { return m_link_flit_bytes; }
     uint64_t getLinkFlitCount() { return m_link_flit_count; }
+    uint64_t getLinkWakeups() const { return m_link_wakeups; }
 
   private:
     const int m_id;
     link_type m_type;
     const Cycles m_latency;
 
+    // Bandwidth model (link_bandwidth == 0 keeps one flit per cycle).
+    // The link earns m_bandwidth bytes of credit per cycle, up to
+    // m_credit_cap, and each network flit spends m_flit_wire_bytes.
+    const Cycles m_serialization_latency;
+    const double m_bandwidth;       // bytes per cycle
+    double m_flit_wire_bytes;       // bytes a network flit takes on the wire
+    double m_credit_cap;
+    double m_byte_credits;
+    Cycles m_credit_cycle;          // cycle m_byte_credits was last updated
+    Cycles m_flit_transfer;         // cycles the last byte of a flit trails
+
     flitBuffer *linkBuffer;
     Consumer *link_consumer;
     flitBuffer *link_srcQueue;
+    // Event queue of link_consumer. Differs from ours when the link
+    // crosses a partition (--parallel-nodes); flits are then handed over
+    // by an event on the consumer's queue, see wakeup().
+    EventQueue *m_consumer_eventq;
 
     // Statistical variables
     unsigned int m_link_utilized;
@@ -107,6 +123,9 @@ class NetworkLink : public ClockedObject, public Consumer
     // DO profiling
     uint64_t m_link_flit_bytes;
     uint64_t m_link_flit_count;
+
+    // Host events spent on this link (see GarnetNetwork::collateStats)
+    uint64_t m_link_wakeups;
 };
 
 #endif // __MEM_RUBY_NETWORK_GARNET2_0_NETWORKLINK_HH__
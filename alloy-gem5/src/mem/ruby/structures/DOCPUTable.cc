@@ -43,6 +43,7 @@
  */
 
 #include "mem/ruby/structures/DOCPUTable.hh"
+#include "base/logging.hh"
 #include "base/trace.hh"
 #include "debug/DOPROTO.hh"
 #include "debug/DOSTORAGE.hh"
@@ -143,4 +144,68 @@ int DOCPUTable::getNumSentReqNotify(void) {
         }
     }
     return ret;
-}
\ No newline at end of file
+}
+
+void
+DOCPUTable::serialize(const std::string &base, CheckpointOut &cp) const
+{
+    std::vector<std::string> mach_types;
+    std::vector<NodeID> mach_nums;
+    std::vector<Cnt_t> st_cnts;
+    std::vector<uint32_t> notify_sent;
+    std::vector<uint32_t> num_epochs;
+    std::vector<Epoch_t> epochs;
+
+    for (const auto &entry : m_map) {
+        mach_types.push_back(MachineType_to_string(entry.first.type));
+        mach_nums.push_back(entry.first.num);
+        st_cnts.push_back(entry.second.stCnt);
+        notify_sent.push_back(entry.second.reqNotifySent);
+        num_epochs.push_back(entry.second.unCommittedEpochs.size());
+        epochs.insert(epochs.end(), entry.second.unCommittedEpochs.begin(),
+                      entry.second.unCommittedEpochs.end());
+    }
+
+    paramOut(cp, base + ".cur_epoch", curEpoch);
+    arrayParamOut(cp, base + ".mach_type", mach_types);
+    arrayParamOut(cp, base + ".mach_num", mach_nums);
+    arrayParamOut(cp, base + ".st_cnt", st_cnts);
+    arrayParamOut(cp, base + ".notify_sent", notify_sent);
+    arrayParamOut(cp, base + ".num_epochs", num_epochs);
+    arrayParamOut(cp, base + ".epochs", epochs);
+}
+
+void
+DOCPUTable::unserialize(const std::string &base, CheckpointIn &cp)
+{
+    // checkpoints from a protocol without DO tables start from empty tables
+    if (!optParamIn(cp, base + ".cur_epoch", curEpoch))
+        return;
+
+    std::vector<std::string> mach_types;
+    std::vector<NodeID> mach_nums;
+    std::vector<Cnt_t> st_cnts;
+    std::vector<uint32_t> notify_sent;
+    std::vector<uint32_t> num_epochs;
+    std::vector<Epoch_t> epochs;
+
+    arrayParamIn(cp, base + ".mach_type", mach_types);
+    arrayParamIn(cp, base + ".mach_num", mach_nums);
+    arrayParamIn(cp, base + ".st_cnt", st_cnts);
+    arrayParamIn(cp, base + ".notify_sent", notify_sent);
+    arrayParamIn(cp, base + ".num_epochs", num_epochs);
+    arrayParamIn(cp, base + ".epochs", epochs);
+
+    m_map.clear();
+    auto epoch_it = epochs.begin();
+    for (size_t i = 0; i < mach_types.size(); ++i) {
+        DOCPUEntry &entry =
+            m_map[checkpointedMachineID(mach_types[i], mach_nums[i])];
+        entry.stCnt = st_cnts[i];
+        entry.reqNotifySent = notify_sent[i];
+        assert(epoch_it + num_epochs[i] <= epochs.end());
+        entry.unCommittedEpochs.insert(epoch_it, epoch_it + num_epochs[i]);
+        epoch_it += num_epochs[i];
+    }
+    assert(epoch_it == epochs.end());
+}
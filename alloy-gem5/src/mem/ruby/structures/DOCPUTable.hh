@@ -46,6 +46,7 @@
 #include "mem/ruby/common/MachineID.hh"
 #include "mem/ruby/common/NetDest.hh"
 #include "mem/ruby/common/TypeDefines.hh"
+#include "sim/serialize.hh"
 
 #include <iostream>
 #include <set>
@@ -82,6 +83,10 @@ public:
     int getNumPendingL2s(MachineID);
     MachineID popOnePendingL2(MachineID);
     int getNumSentReqNotify();
+
+    // checkpointed under the owning controller's section
+    void serialize(const std::string &base, CheckpointOut &cp) const;
+    void unserialize(const std::string &base, CheckpointIn &cp);
 };
 
 #endif // __MEM_RUBY_STRUCTURES_DOCPUTABLE_HH__
\ No newline at end of file
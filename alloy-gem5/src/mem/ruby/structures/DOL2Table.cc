@@ -43,6 +43,7 @@
  */
 
 #include "mem/ruby/structures/DOL2Table.hh"
+#include "base/logging.hh"
 #include "base/trace.hh"
 #include "debug/DOPROTO.hh"
 #include "debug/DOSTORAGE.hh"
@@ -183,4 +184,105 @@ void DOL2Table::markNotiSent(MachineID c_id, Epoch_t epoch) {
     allocated(c_id);
     auto &stCnts = m_map[c_id].stCnts;
     stCnts.erase(epoch);
-}
\ No newline at end of file
+}
+
+void DOL2Table::armDoorbell(Addr addr, MachineID c_id) {
+    m_doorbells[addr].add(c_id);
+}
+
+bool DOL2Table::hasDoorbells(Addr addr) const {
+    return m_doorbells.count(addr) > 0;
+}
+
+NetDest DOL2Table::takeDoorbells(Addr addr) {
+    auto it = m_doorbells.find(addr);
+    assert(it != m_doorbells.end());
+    NetDest dests = it->second;
+    m_doorbells.erase(it);
+    return dests;
+}
+
+void
+DOL2Table::serialize(const std::string &base, CheckpointOut &cp) const
+{
+    std::vector<std::string> mach_types;
+    std::vector<NodeID> mach_nums;
+    std::vector<Epoch_t> max_committed;
+    std::vector<uint32_t> num_st_cnts;
+    std::vector<Epoch_t> st_epochs;
+    std::vector<Cnt_t> st_cnts;
+    std::vector<uint32_t> num_noti_cnts;
+    std::vector<Epoch_t> noti_epochs;
+    std::vector<uint32_t> noti_cnts;
+
+    for (const auto &entry : m_map) {
+        mach_types.push_back(MachineType_to_string(entry.first.type));
+        mach_nums.push_back(entry.first.num);
+        max_committed.push_back(entry.second.maxCommittedEpochs);
+        num_st_cnts.push_back(entry.second.stCnts.size());
+        for (const auto &cnt : entry.second.stCnts) {
+            st_epochs.push_back(cnt.first);
+            st_cnts.push_back(cnt.second);
+        }
+        num_noti_cnts.push_back(entry.second.notiCnts.size());
+        for (const auto &cnt : entry.second.notiCnts) {
+            noti_epochs.push_back(cnt.first);
+            noti_cnts.push_back(cnt.second);
+        }
+    }
+
+    arrayParamOut(cp, base + ".mach_type", mach_types);
+    arrayParamOut(cp, base + ".mach_num", mach_nums);
+    arrayParamOut(cp, base + ".max_committed", max_committed);
+    arrayParamOut(cp, base + ".num_st_cnts", num_st_cnts);
+    arrayParamOut(cp, base + ".st_epochs", st_epochs);
+    arrayParamOut(cp, base + ".st_cnts", st_cnts);
+    arrayParamOut(cp, base + ".num_noti_cnts", num_noti_cnts);
+    arrayParamOut(cp, base + ".noti_epochs", noti_epochs);
+    arrayParamOut(cp, base + ".noti_cnts", noti_cnts);
+}
+
+void
+DOL2Table::unserialize(const std::string &base, CheckpointIn &cp)
+{
+    // checkpoints from a protocol without DO tables start from empty tables
+    if (!cp.entryExists(Serializable::currentSection(), base + ".mach_type"))
+        return;
+
+    std::vector<std::string> mach_types;
+    std::vector<NodeID> mach_nums;
+    std::vector<Epoch_t> max_committed;
+    std::vector<uint32_t> num_st_cnts;
+    std::vector<Epoch_t> st_epochs;
+    std::vector<Cnt_t> st_cnts;
+    std::vector<uint32_t> num_noti_cnts;
+    std::vector<Epoch_t> noti_epochs;
+    std::vector<uint32_t> noti_cnts;
+
+    arrayParamIn(cp, base + ".mach_type", mach_types);
+    arrayParamIn(cp, base + ".mach_num", mach_nums);
+    arrayParamIn(cp, base + ".max_committed", max_committed);
+    arrayParamIn(cp, base + ".num_st_cnts", num_st_cnts);
+    arrayParamIn(cp, base + ".st_epochs", st_epochs);
+    arrayParamIn(cp, base + ".st_cnts", st_cnts);
+    arrayParamIn(cp, base + ".num_noti_cnts", num_noti_cnts);
+    arrayParamIn(cp, base + ".noti_epochs", noti_epochs);
+    arrayParamIn(cp, base + ".noti_cnts", noti_cnts);
+    assert(st_epochs.size() == st_cnts.size());
+    assert(noti_epochs.size() == noti_cnts.size());
+
+    m_map.clear();
+    size_t st_idx = 0;
+    size_t noti_idx = 0;
+    for (size_t i = 0; i < mach_types.size(); ++i) {
+        DOL2Entry &entry =
+            m_map[checkpointedMachineID(mach_types[i], mach_nums[i])];
+        entry.maxCommittedEpochs = max_committed[i];
+        for (uint32_t j = 0; j < num_st_cnts[i]; ++j, ++st_idx)
+            entry.stCnts[st_epochs[st_idx]] = st_cnts[st_idx];
+        for (uint32_t j = 0; j < num_noti_cnts[i]; ++j, ++noti_idx)
+            entry.notiCnts[noti_epochs[noti_idx]] = noti_cnts[noti_idx];
+    }
+    assert(st_idx == st_epochs.size());
+    assert(noti_idx == noti_epochs.size());
+}
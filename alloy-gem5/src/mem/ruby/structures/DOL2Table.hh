@@ -46,6 +46,7 @@
 #include "mem/ruby/common/MachineID.hh"
 #include "mem/ruby/common/NetDest.hh"
 #include "mem/ruby/common/TypeDefines.hh"
+#include "sim/serialize.hh"
 
 #include <iostream>
 #include <set>
@@ -63,6 +64,9 @@ class DOL2Table
 {
 private:
     std::unordered_map<MachineID, DOL2Entry, MachineIDHash> m_map;
+    // L1s to wake on the next ST_REL to a line; armed watches are
+    // transient and are not checkpointed
+    std::unordered_map<Addr, NetDest> m_doorbells;
 public:
     bool allocated(MachineID);
     void allocate(MachineID);
@@ -75,6 +79,13 @@ public:
     bool canCommit(MachineID, Epoch_t, Cnt_t, uint32_t, Epoch_t);
     bool canSendNotify(MachineID, Epoch_t, Cnt_t, Epoch_t);
     void markNotiSent(MachineID, Epoch_t);
+    void armDoorbell(Addr, MachineID);
+    bool hasDoorbells(Addr) const;
+    NetDest takeDoorbells(Addr);
+
+    // checkpointed under the owning controller's section
+    void serialize(const std::string &base, CheckpointOut &cp) const;
+    void unserialize(const std::string &base, CheckpointIn &cp);
 };
 
 #endif // __MEM_RUBY_STRUCTURES_DOL2TABLE_HH__
\ No newline at end of file
@@ -67,7 +67,7 @@ DOSequencerParams::create()
 }
 
 DOSequencer::DOSequencer(const Params *p)
-    : Sequencer(p)
+    : DOSequencerBase(p)
 {
     // set dummy data
     Word_t dummyVal = MARKER_ST_NT;
@@ -80,11 +80,18 @@ DOSequencer::~DOSequencer()
 {
 }
 
+Process *
+DOSequencer::requestProcess(PacketPtr pkt)
+{
+    ContextID cid = pkt->req->hasContextId() ? pkt->req->contextId() : 0;
+    return system->getThreadContext(cid)->getProcessPtr();
+}
+
 bool
 DOSequencer::isSTNT(PacketPtr pkt)
 {
     // return pkt->isWrite() && (pkt->getSize() == sizeof(Word_t)) && (((*(pkt->getConstPtr<Word_t>())) & (~VAL_ST_NT_MASK)) == MARKER_ST_NT) && (pkt->getAddr() < STACK_ADDR);
-    return pkt->isWrite() && system->getThreadContext(0)->getProcessPtr()->isSTNTVaddrRange(pkt->getAddr());
+    return pkt->isWrite() && requestProcess(pkt)->isSTNTVaddrRange(pkt->getAddr());
 }
 
 bool
@@ -93,19 +100,19 @@ DOSequencer::isSTREL(PacketPtr pkt)
     // the reason of this stack addr check is because somehow there are unintended store releases
     // the guess is register spill to stack. So if that happens we must not account the stack write as a release store
     // return pkt->isWrite() && (pkt->getSize() == sizeof(Word_t)) && (((*(pkt->getConstPtr<Word_t>())) & (~VAL_ST_REL_MASK)) == MARKER_ST_REL) && (pkt->getAddr() < STACK_ADDR);
-    return pkt->isWrite() && system->getThreadContext(0)->getProcessPtr()->isSTRELVaddrRange(pkt->getAddr());
+    return pkt->isWrite() && requestProcess(pkt)->isSTRELVaddrRange(pkt->getAddr());
 }
 
 bool
 DOSequencer::isLDNT(PacketPtr pkt)
 {
-    return pkt->isRead() && system->getThreadContext(0)->getProcessPtr()->isSTNTVaddrRange(pkt->getAddr());
+    return pkt->isRead() && requestProcess(pkt)->isSTNTVaddrRange(pkt->getAddr());
 }
 
 bool
 DOSequencer::isLDACQ(PacketPtr pkt)
 {
-    return pkt->isRead() && system->getThreadContext(0)->getProcessPtr()->isSTRELVaddrRange(pkt->getAddr());
+    return pkt->isRead() && requestProcess(pkt)->isSTRELVaddrRange(pkt->getAddr());
 }
 
 void
@@ -268,6 +275,9 @@ DOSequencer::readCallback(Addr address, DataBlock& data,
 
     DO_readRequestTable.erase(i);
     DOMarkRemoved();
+    if (request->m_type == RubyRequestType_LD_ACQ) {
+        acquireDone(request->issue_time);
+    }
 
     assert((request->m_type == RubyRequestType_LD) ||
            (request->m_type == RubyRequestType_LD_NT) ||
@@ -281,6 +291,9 @@ DOSequencer::readCallback(Addr address, DataBlock& data,
     } else { // these are "fake" lds triggered by ld-st, should not have effect on the processor
         DPRINTF(RRC, "ReadCallbackFake [0x%x] m_type[%d]\n", address, request->m_type);
         delete request;
+        // fake requests complete without a packet going back to the
+        // CPU, so a pending drain must be checked here as well
+        testDrainComplete();
     }
 }
 
@@ -345,6 +358,7 @@ DOSequencer::writeCallback(Addr address, DataBlock& data,
                 initialRequestTime, forwardRequestTime, firstResponseTime);
     } else { // fake st triggered by st-nt and st-rel
         DPRINTF(RRC, "WriteCallbackFake [0x%x] m_type[%d]\n", address, request->m_type);
+        DOStoreAcked(request->m_type, request->issue_time);
         // if fake st is not wt, the data must be correctly copied to cache here.
 #ifdef NO_WT
         DPRINTF(RRC, "WriteCallbackSetDataOnly [0x%x] m_type[%d]\n", address, request->m_type);
@@ -355,6 +369,9 @@ DOSequencer::writeCallback(Addr address, DataBlock& data,
         // need to be fixed later
 #endif
         delete request;
+        // fake requests complete without a packet going back to the
+        // CPU, so a pending drain must be checked here as well
+        testDrainComplete();
     }
 }
 
@@ -658,6 +675,7 @@ DOSequencer::DOinsertRequest(PacketPtr pkt, RubyRequestType request_type)
             assert(r != DO_writeRequestTable.end());
             r->second = new SequencerRequest(pkt, request_type, curCycle());
             if (request_type == RubyRequestType_ST_NT || request_type == RubyRequestType_ST_REL) {
+                DOStoreIssued(request_type);
                 // TimingSimpleCPU does not care about st's return value, so return dummy data is fine.
                 hitCallback(r->second, dummyData, true, MachineType_NUM, true,
                     Cycles(0), Cycles(0), Cycles(0));
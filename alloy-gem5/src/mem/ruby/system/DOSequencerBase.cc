@@ -0,0 +1,132 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: LicenseRef-NvidiaProprietary
+ *
+ * NVIDIA CORPORATION, its affiliates and licensors retain all intellectual
+ * property and proprietary rights in and to this material, related
+ * documentation and any modifications thereto. Any use, reproduction,
+ * disclosure or distribution of this material and related documentation
+ * without an express license agreement from NVIDIA CORPORATION or
+ * its affiliates is strictly prohibited.
+ */
+
+#include "mem/ruby/system/DOSequencerBase.hh"
+
+#include "cpu/thread_context.hh"
+#include "debug/ProtocolTrace.hh"
+#include "mem/protocol/RubyAccessMode.hh"
+#include "mem/ruby/slicc_interface/RubyRequest.hh"
+#include "sim/process.hh"
+#include "sim/system.hh"
+
+DOSequencerBase::DOSequencerBase(const DOSequencerParams *p)
+    : Sequencer(p)
+{
+    // one hart per core, so the sequencer version is the hart's context id
+    system->registerDOCounters(m_version);
+    if (p->doorbells) {
+        system->registerDoorbellArmer(m_version,
+            [this](Addr paddr) { armDoorbell(paddr); });
+        system->registerMonitorSetter(m_version,
+            [this](Addr paddr) { setMonitor(paddr); });
+    }
+}
+
+void
+DOSequencerBase::regStats()
+{
+    Sequencer::regStats();
+
+    m_releaseLatencyHist
+        .init(10)
+        .name(name() + ".release_latency")
+        .desc("cycles from ST_REL issue to its ack")
+        .flags(Stats::nozero | Stats::pdf);
+
+    m_doStoreBufferHist
+        .init(16)
+        .name(name() + ".do_store_buffer")
+        .desc("ST_NT/ST_REL awaiting their ack, sampled on issue")
+        .flags(Stats::nozero | Stats::pdf);
+}
+
+void
+DOSequencerBase::armDoorbell(Addr paddr)
+{
+    // not a memory access: no packet, no data, never allocates in the L1
+    auto msg = std::make_shared<RubyRequest>(clockEdge(),
+                                        makeLineAddress(paddr), nullptr, 0,
+                                        0, RubyRequestType_DOORBELL_ARM,
+                                        RubyRequestType_DOORBELL_ARM,
+                                        RubyAccessMode_User, nullptr);
+    DPRINTFR(ProtocolTrace, "%15s %3s %10s%20s %6s>%-6s %#x %s\n",
+            curTick(), m_version, "Seq", "Begin", "", "",
+            printAddress(msg->getPhysicalAddress()),
+            RubyRequestType_to_string(RubyRequestType_DOORBELL_ARM));
+    assert(m_mandatory_q_ptr != NULL);
+    m_mandatory_q_ptr->enqueue(msg, clockEdge(),
+                               cyclesToTicks(m_data_cache_hit_latency));
+}
+
+void
+DOSequencerBase::doorbellArmed(Addr address)
+{
+    ThreadContext *tc = system->getThreadContext(m_version);
+    tc->getProcessPtr()->doorbellArmed(tc);
+}
+
+void
+DOSequencerBase::doorbellRang(Addr address)
+{
+    ThreadContext *tc = system->getThreadContext(m_version);
+    tc->getProcessPtr()->doorbellRang(tc);
+    monitorCheck(address);
+}
+
+void
+DOSequencerBase::setMonitor(Addr paddr)
+{
+    m_monitorLine = makeLineAddress(paddr);
+}
+
+void
+DOSequencerBase::monitorCheck(Addr address)
+{
+    if (address != m_monitorLine)
+        return;
+    m_monitorLine = MaxAddr;
+    ThreadContext *tc = system->getThreadContext(m_version);
+    tc->getProcessPtr()->monitorTriggered(tc);
+}
+
+void
+DOSequencerBase::DOStoreIssued(RubyRequestType type)
+{
+    assert(type == RubyRequestType_ST_NT || type == RubyRequestType_ST_REL);
+    m_outstandingDOStores++;
+    m_doStoreBufferHist.sample(m_outstandingDOStores);
+    if (type == RubyRequestType_ST_NT)
+        system->doCounters(m_version).stnt++;
+    else
+        system->doCounters(m_version).strel++;
+}
+
+void
+DOSequencerBase::DOStoreAcked(RubyRequestType type, Cycles issue_time)
+{
+    assert(m_outstandingDOStores > 0);
+    m_outstandingDOStores--;
+    if (type == RubyRequestType_ST_REL) {
+        assert(curCycle() >= issue_time);
+        m_releaseLatencyHist.sample(curCycle() - issue_time);
+        system->doCounters(m_version).relLatencyTicks +=
+            cyclesToTicks(curCycle() - issue_time);
+    }
+}
+
+void
+DOSequencerBase::acquireDone(Cycles issue_time)
+{
+    system->doCounters(m_version).acqStallTicks +=
+        cyclesToTicks(curCycle() - issue_time);
+}
@@ -0,0 +1,66 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: LicenseRef-NvidiaProprietary
+ *
+ * NVIDIA CORPORATION, its affiliates and licensors retain all intellectual
+ * property and proprietary rights in and to this material, related
+ * documentation and any modifications thereto. Any use, reproduction,
+ * disclosure or distribution of this material and related documentation
+ * without an express license agreement from NVIDIA CORPORATION or
+ * its affiliates is strictly prohibited.
+ */
+
+#ifndef __MEM_RUBY_SYSTEM_DO_SEQUENCER_BASE_HH__
+#define __MEM_RUBY_SYSTEM_DO_SEQUENCER_BASE_HH__
+
+#include "base/statistics.hh"
+#include "mem/protocol/RubyRequestType.hh"
+#include "mem/ruby/common/Address.hh"
+#include "mem/ruby/system/Sequencer.hh"
+#include "params/DOSequencer.hh"
+
+/**
+ * What the DOSequencer variants (DOSequencer.cc, DOSequencerRC.cc,
+ * DOSequencerTSO.cc, DOSequencerTSOWB.cc) share, whichever of them is
+ * built: the doorbell and monitor hooks, the ST_NT/ST_REL stats and the
+ * per-hart DO counters (System::doCounters).
+ */
+class DOSequencerBase : public Sequencer
+{
+  public:
+    DOSequencerBase(const DOSequencerParams *p);
+
+    void regStats() override;
+
+    // doorbells: watch a line for the next ST_REL committed at its L2
+    void armDoorbell(Addr paddr);
+    void doorbellArmed(Addr address);
+    void doorbellRang(Addr address);
+
+    // monitor/mwait: wake the hart when the monitored line leaves the L1
+    void setMonitor(Addr paddr);
+    void monitorCheck(Addr address);
+
+  protected:
+    // an ST_NT or ST_REL was issued; it is acked to the core at once
+    void DOStoreIssued(RubyRequestType type);
+    // the L1/L2 acked an ST_NT or ST_REL issued at issue_time
+    void DOStoreAcked(RubyRequestType type, Cycles issue_time);
+    // an LD_ACQ issued at issue_time got its data
+    void acquireDone(Cycles issue_time);
+
+  private:
+    // line watched by CSR_MONITOR, MaxAddr if none
+    Addr m_monitorLine = MaxAddr;
+
+    // ST_REL issue to the final ack in writeCallback, i.e. the latency a
+    // following LD_ACQ may observe on the release critical path
+    Stats::Histogram m_releaseLatencyHist;
+
+    // ST_NT/ST_REL are acked to the core on issue, so they wait here for
+    // the L1/L2 ack instead of in the core's store buffer
+    int m_outstandingDOStores = 0;
+    Stats::Histogram m_doStoreBufferHist;
+};
+
+#endif // __MEM_RUBY_SYSTEM_DO_SEQUENCER_BASE_HH__
@@ -67,7 +67,7 @@ DOSequencerParams::create()
 }
 
 DOSequencer::DOSequencer(const Params *p)
-    : Sequencer(p)
+    : DOSequencerBase(p)
 {
     // set dummy data
     Word_t dummyVal = MARKER_ST_NT;
@@ -80,14 +80,21 @@ DOSequencer::~DOSequencer()
 {
 }
 
+Process *
+DOSequencer::requestProcess(PacketPtr pkt)
+{
+    ContextID cid = pkt->req->hasContextId() ? pkt->req->contextId() : 0;
+    return system->getThreadContext(cid)->getProcessPtr();
+}
+
 bool
 DOSequencer::isSTNT(PacketPtr pkt)
 {
-    if (pkt->isWrite() && system->getThreadContext(0)->getProcessPtr()->isSTNTVaddrRange(pkt->getAddr())) {
+    if (pkt->isWrite() && requestProcess(pkt)->isSTNTVaddrRange(pkt->getAddr())) {
         DPRINTF(DOACC, "st-nt Addr[0x%x] isAmo[%d] islockedRMW[%d]\n", pkt->getAddr(), pkt->isAtomicOp(), pkt->req->isLockedRMW());
     }
     return false;
-    // return pkt->isWrite() && system->getThreadContext(0)->getProcessPtr()->isSTNTVaddrRange(pkt->getAddr());
+    // return pkt->isWrite() && requestProcess(pkt)->isSTNTVaddrRange(pkt->getAddr());
 }
 
 bool
@@ -95,31 +102,31 @@ DOSequencer::isSTREL(PacketPtr pkt)
 {
     // the reason of this stack addr check is because somehow there are unintended store releases
     // the guess is register spill to stack. So if that happens we must not account the stack write as a release store
-    if (pkt->isWrite() && system->getThreadContext(0)->getProcessPtr()->isSTRELVaddrRange(pkt->getAddr())) {
+    if (pkt->isWrite() && requestProcess(pkt)->isSTRELVaddrRange(pkt->getAddr())) {
         DPRINTF(DOACC, "st-rel Addr[0x%x] isAmo[%d] islockedRMW[%d]\n", pkt->getAddr(), pkt->isAtomicOp(), pkt->req->isLockedRMW());
     }
-    return pkt->isWrite() && (system->getThreadContext(0)->getProcessPtr()->isSTRELVaddrRange(pkt->getAddr()) ||
-            system->getThreadContext(0)->getProcessPtr()->isSTNTVaddrRange(pkt->getAddr()));
+    return pkt->isWrite() && (requestProcess(pkt)->isSTRELVaddrRange(pkt->getAddr()) ||
+            requestProcess(pkt)->isSTNTVaddrRange(pkt->getAddr()));
 }
 
 bool
 DOSequencer::isLDNT(PacketPtr pkt)
 {       
-    if (pkt->isRead() && system->getThreadContext(0)->getProcessPtr()->isSTNTVaddrRange(pkt->getAddr())) {
+    if (pkt->isRead() && requestProcess(pkt)->isSTNTVaddrRange(pkt->getAddr())) {
         DPRINTF(DOACC, "ld-nt Addr[0x%x]\n", pkt->getAddr());
     }
     return false;
-    // return pkt->isRead() && system->getThreadContext(0)->getProcessPtr()->isSTNTVaddrRange(pkt->getAddr());
+    // return pkt->isRead() && requestProcess(pkt)->isSTNTVaddrRange(pkt->getAddr());
 }
 
 bool
 DOSequencer::isLDACQ(PacketPtr pkt)
 {
-    if (pkt->isRead() && system->getThreadContext(0)->getProcessPtr()->isSTRELVaddrRange(pkt->getAddr())) {
+    if (pkt->isRead() && requestProcess(pkt)->isSTRELVaddrRange(pkt->getAddr())) {
         DPRINTF(DOACC, "ld-acq Addr[0x%x]\n", pkt->getAddr());
     }
-    return pkt->isRead() && (system->getThreadContext(0)->getProcessPtr()->isSTRELVaddrRange(pkt->getAddr()) ||
-           system->getThreadContext(0)->getProcessPtr()->isSTNTVaddrRange(pkt->getAddr()));
+    return pkt->isRead() && (requestProcess(pkt)->isSTRELVaddrRange(pkt->getAddr()) ||
+           requestProcess(pkt)->isSTNTVaddrRange(pkt->getAddr()));
 }
 
 void
@@ -282,6 +289,9 @@ DOSequencer::readCallback(Addr address, DataBlock& data,
 
     DO_readRequestTable.erase(i);
     DOMarkRemoved();
+    if (request->m_type == RubyRequestType_LD_ACQ) {
+        acquireDone(request->issue_time);
+    }
 
     assert((request->m_type == RubyRequestType_LD) ||
            (request->m_type == RubyRequestType_LD_NT) ||
@@ -295,6 +305,9 @@ DOSequencer::readCallback(Addr address, DataBlock& data,
     } else { // these are "fake" lds triggered by ld-st, should not have effect on the processor
         DPRINTF(RRC, "ReadCallbackFake [0x%x] m_type[%d]\n", address, request->m_type);
         delete request;
+        // fake requests complete without a packet going back to the
+        // CPU, so a pending drain must be checked here as well
+        testDrainComplete();
     }
 }
 
@@ -359,6 +372,7 @@ DOSequencer::writeCallback(Addr address, DataBlock& data,
                 initialRequestTime, forwardRequestTime, firstResponseTime);
     } else { // fake st triggered by st-nt and st-rel
         DPRINTF(RRC, "WriteCallbackFake [0x%x] m_type[%d]\n", address, request->m_type);
+        DOStoreAcked(request->m_type, request->issue_time);
         // if fake st is not wt, the data must be correctly copied to cache here.
 #ifdef NO_WT
         DPRINTF(RRC, "WriteCallbackSetDataOnly [0x%x] m_type[%d]\n", address, request->m_type);
@@ -369,6 +383,9 @@ DOSequencer::writeCallback(Addr address, DataBlock& data,
         // need to be fixed later
 #endif
         delete request;
+        // fake requests complete without a packet going back to the
+        // CPU, so a pending drain must be checked here as well
+        testDrainComplete();
     }
 }
 
@@ -672,6 +689,7 @@ DOSequencer::DOinsertRequest(PacketPtr pkt, RubyRequestType request_type)
             assert(r != DO_writeRequestTable.end());
             r->second = new SequencerRequest(pkt, request_type, curCycle());
             if (request_type == RubyRequestType_ST_NT || request_type == RubyRequestType_ST_REL) {
+                DOStoreIssued(request_type);
                 // TimingSimpleCPU does not care about st's return value, so return dummy data is fine.
                 hitCallback(r->second, dummyData, true, MachineType_NUM, true,
                     Cycles(0), Cycles(0), Cycles(0));
@@ -51,11 +51,14 @@
 #include "mem/protocol/SequencerRequestType.hh"
 #include "mem/ruby/common/Address.hh"
 #include "mem/ruby/structures/CacheMemory.hh"
+#include "mem/ruby/system/DOSequencerBase.hh"
 #include "mem/ruby/system/RubyPort.hh"
 #include "mem/ruby/system/Sequencer.hh"
 #include "params/DOSequencer.hh"
 
-class DOSequencer : public Sequencer
+class Process;
+
+class DOSequencer : public DOSequencerBase
 {
 public:
     // using Sequencer::Sequencer;
@@ -118,6 +121,8 @@ private:
     DORequestTable DO_writeRequestTable;
     DORequestTable DO_readRequestTable;
 
+    // DO ranges are per address space, so ask the requester's process
+    Process *requestProcess(PacketPtr pkt);
     bool isSTNT(PacketPtr pkt);
     bool isSTREL(PacketPtr pkt);
     bool isLDNT(PacketPtr pkt);
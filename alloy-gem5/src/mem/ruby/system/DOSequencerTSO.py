@@ -46,3 +46,5 @@ class DOSequencer(RubySequencer):
    type = 'DOSequencer'
    cxx_class = 'DOSequencer'
    cxx_header = "mem/ruby/system/DOSequencer.hh"
+   doorbells = Param.Bool(False,
+       "the L1 protocol supports doorbells and monitor/mwait")
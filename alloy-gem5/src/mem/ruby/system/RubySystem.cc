@@ -229,7 +229,7 @@ RubySystem::memWriteback()
                 MemCmd::Command cmd = MemCmd::WriteReq;
                 Packet* pkt = new Packet(req, cmd);
                 pkt->dataDynamic(new uint8_t);
-                pkt->setData(rec_p->m_data);
+                pkt->setData(rec_p->m_data + offset);
 
                 directory_p->functionalMemoryWrite(pkt);
 
@@ -324,6 +324,8 @@ class $c_ident : public AbstractController
     void collateStats();
 
     void recordCacheTrace(int cntrl, CacheRecorder* tr);
+    void serialize(CheckpointOut &cp) const override;
+    void unserialize(CheckpointIn &cp) override;
     Sequencer* getCPUSequencer() const;
     GPUCoalescer* getGPUCoalescer() const;
 
@@ -949,6 +951,36 @@ $c_ident::recordCacheTrace(int cntrl, CacheRecorder* tr)
         code('''
 }
 
+void
+$c_ident::serialize(CheckpointOut &cp) const
+{
+    AbstractController::serialize(cp);
+''')
+        #
+        # Structures declared with checkpoint="yes" (e.g., the DO tables)
+        # carry protocol state that the cache trace cannot rebuild.
+        #
+        code.indent()
+        for var in self.objects:
+            if "checkpoint" in var.type:
+                code('m_${{var.ident}}_ptr->serialize("${{var.ident}}", cp);')
+        code.dedent()
+        code('''
+}
+
+void
+$c_ident::unserialize(CheckpointIn &cp)
+{
+    AbstractController::unserialize(cp);
+''')
+        code.indent()
+        for var in self.objects:
+            if "checkpoint" in var.type:
+                code('m_${{var.ident}}_ptr->unserialize("${{var.ident}}", cp);')
+        code.dedent()
+        code('''
+}
+
 // Actions
 ''')
         if self.TBEType != None and self.EntryType != None:
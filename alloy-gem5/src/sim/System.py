@@ -137,4 +137,7 @@ class System(MemObject):
 
     brg_fast_forward = Param.Bool(False, "Using --brg-fast-forward option")
     num_nodes = Param.Int(1, "Using --num-nodes option")
-    num_cores = Param.Int(1, "Using --num-cores option")
\ No newline at end of file
+    num_cores = Param.Int(1, "Using --num-cores option")
+    handoff_quantum = Param.Tick(0, "Inside the ROI, hand page-table "
+        "changes and wake-ups off to the boundaries of this quantum "
+        "(--parallel-nodes, --parallel-reference); 0 does them in place")
@@ -54,6 +54,7 @@
 #include "mem/page_table.hh"
 #include "sim/full_system.hh"
 #include "sim/process.hh"
+#include "sim/system.hh"
 
 void FaultBase::invoke(ThreadContext * tc, const StaticInstPtr &inst)
 {
@@ -84,6 +85,23 @@ void GenericPageTableFault::invoke(ThreadContext *tc, const StaticInstPtr &inst)
     bool handled = false;
     if (!FullSystem) {
         Process *p = tc->getProcessPtr();
+        System *sys = tc->getSystemPtr();
+        if (sys->handoffActive()) {
+            // grow the stack at the handoff (see System::handoffQuantum),
+            // then re-execute
+            ContextID cid = tc->contextId();
+            Addr fault_vaddr = vaddr;
+            sys->handOff(cid, curTick(), [p, sys, cid, fault_vaddr] {
+                ThreadContext *tc = sys->getThreadContext(cid);
+                if (!p->fixupStackFaultThreadCtx(fault_vaddr, tc))
+                    panic("Page table fault when accessing virtual address "
+                          "%#x\n", fault_vaddr);
+                tc->activate();
+            });
+            tc->suspend();
+            return;
+        }
+
         // DPRINTF(RRC, "invoke page fault\n");
         handled = p->fixupStackFaultThreadCtx(vaddr, tc);
 
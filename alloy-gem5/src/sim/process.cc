@@ -62,9 +62,12 @@
 #include <fcntl.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <array>
 #include <csignal>
+#include <iterator>
 #include <map>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -73,6 +76,7 @@
 #include "base/loader/symtab.hh"
 #include "base/statistics.hh"
 #include "config/the_isa.hh"
+#include "cpu/base.hh"
 #include "cpu/thread_context.hh"
 #include "mem/page_table.hh"
 #include "mem/se_translating_port_proxy.hh"
@@ -80,6 +84,7 @@
 #include "sim/emul_driver.hh"
 #include "sim/fd_array.hh"
 #include "sim/fd_entry.hh"
+#include "sim/faults.hh"
 #include "sim/syscall_desc.hh"
 #include "sim/system.hh"
 #include "debug/RRC.hh"
@@ -131,6 +136,8 @@ Process::Process(ProcessParams *params, EmulationPageTable *pTable,
       _pid(params->pid), _ppid(params->ppid),
       _pgid(params->pgid), drivers(params->drivers),
       fds(make_shared<FDArray>(params->input, params->output, params->errout)),
+      stntRanges(make_shared<DOVaddrRanges>()),
+      strelRanges(make_shared<DOVaddrRanges>()),
       childClearTID(0),
       needToInitArgs(true)
 {
@@ -193,6 +200,8 @@ Process::clone(ThreadContext *otc, ThreadContext *ntc,
         ntc->getMemProxy().setPageTable(np->pTable);
 
         np->memState = memState;
+        np->stntRanges = stntRanges;
+        np->strelRanges = strelRanges;
     } else {
         /**
          * Duplicate the process memory address space. The state needs to be
@@ -209,6 +218,8 @@ Process::clone(ThreadContext *otc, ThreadContext *ntc,
         }
 
         *np->memState = *memState;
+        *np->stntRanges = *stntRanges;
+        *np->strelRanges = *strelRanges;
     }
 
     if (CLONE_FILES & flags) {
@@ -272,6 +283,294 @@ Process::regStats()
         .name(name() + ".numSyscalls")
         .desc("Number of system calls")
         ;
+
+    numBarriers
+        .name(name() + ".numBarriers")
+        .desc("Number of completed gem5 barriers")
+        ;
+
+    barrierWaitTicks
+        .init(16)
+        .name(name() + ".barrierWaitTicks")
+        .desc("Ticks a thread spent suspended in a gem5 barrier")
+        .flags(nozero)
+        ;
+
+    barrierWaitTicksPerId
+        .init(maxBarrierStatIds + 1)
+        .name(name() + ".barrierWaitTicksPerId")
+        .desc("Total ticks threads spent waiting, per barrier id")
+        .flags(nozero)
+        ;
+    for (uint64_t i = 0; i < maxBarrierStatIds; ++i)
+        barrierWaitTicksPerId.subname(i, std::to_string(i));
+    barrierWaitTicksPerId.subname(maxBarrierStatIds, "other");
+
+    numDoorbellWakeups
+        .name(name() + ".numDoorbellWakeups")
+        .desc("Number of threads woken up by a doorbell")
+        ;
+
+    doorbellWaitTicks
+        .init(16)
+        .name(name() + ".doorbellWaitTicks")
+        .desc("Ticks a thread spent suspended waiting for a doorbell")
+        .flags(nozero)
+        ;
+
+    numMwaitWakeups
+        .name(name() + ".numMwaitWakeups")
+        .desc("Number of mwaits ended by their monitor")
+        ;
+
+    numMwaitTimeouts
+        .name(name() + ".numMwaitTimeouts")
+        .desc("Number of mwaits ended by their timeout")
+        ;
+
+    mwaitTicks
+        .init(16)
+        .name(name() + ".mwaitTicks")
+        .desc("Ticks a thread spent suspended in mwait")
+        .flags(nozero)
+        ;
+}
+
+void
+Process::barrierInit(uint64_t n_threads)
+{
+    auto lock = system->sharedStateLock();
+    assert(system->barrierPending.empty());
+    system->n_barrier_waiters = n_threads;
+    system->barriers.clear();
+}
+
+void
+Process::barrierInitId(uint64_t n_threads, int cpu_id)
+{
+    auto lock = system->sharedStateLock();
+    // a barrier that already has waiters keeps the count it started with
+    system->barrierIdWaiters[barrier_init_id[cpu_id]] = n_threads;
+}
+
+void
+Process::barrierWait(uint64_t bar_id, ThreadContext *tc)
+{
+    auto lock = system->sharedStateLock();
+    System::Barrier &bar = system->barriers[bar_id];
+    if (bar.waiters.empty()) {
+        auto it = system->barrierIdWaiters.find(bar_id);
+        bar.n_waiters = it != system->barrierIdWaiters.end() ?
+            it->second : system->n_barrier_waiters;
+    }
+    std::vector<System::BarrierWaiter> &waiters = bar.waiters;
+    waiters.push_back({tc, curTick()});
+    assert(waiters.size() <= bar.n_waiters);
+
+    if (waiters.size() < bar.n_waiters) {
+        // same as a FUTEX_WAIT: the barrier instruction completes and the
+        // thread is woken up by the last arrival
+        system->barrierPending.insert(tc->contextId());
+        tc->suspend();
+        return;
+    }
+
+    // last arrival, release everybody as of the latest arrival: on
+    // parallel queues the last to take the lock may be earlier in
+    // simulated time
+    Tick release = 0;
+    for (auto &waiter : waiters)
+        release = std::max(release, waiter.arrival);
+    for (auto &waiter : waiters) {
+        Tick wait = release - waiter.arrival;
+        barrierWaitTicks.sample(wait);
+        barrierWaitTicksPerId[bar_id < maxBarrierStatIds ?
+                              bar_id : maxBarrierStatIds] += wait;
+        system->doCounters(waiter.tc->contextId()).barrierWaitTicks += wait;
+        if (waiter.tc != tc) {
+            system->barrierPending.erase(waiter.tc->contextId());
+            system->wakeupContext(waiter.tc, release);
+        }
+    }
+    // and must not run ahead of the release, so with a handoff it is
+    // woken up like the others
+    if (system->handoffActive()) {
+        tc->suspend();
+        system->wakeupContext(tc, release);
+    }
+    numBarriers++;
+    system->barriers.erase(bar_id);
+}
+
+int
+Process::barrierReady(ThreadContext *tc)
+{
+    auto lock = system->sharedStateLock();
+    return system->barrierPending.count(tc->contextId()) == 0;
+}
+
+void
+Process::doorbellArm(Addr vaddr, ThreadContext *tc)
+{
+    auto lock = system->sharedStateLock();
+    ContextID cid = tc->contextId();
+    Addr paddr;
+    // without a timing L1 to watch the line (atomic warmup, protocols
+    // other than DO) the arm is a no-op and the caller keeps polling
+    if (!system->isTimingMode() ||
+        system->doorbellArmers.size() <= (size_t)cid ||
+        !system->doorbellArmers[cid] || !pTable->translate(vaddr, paddr))
+        return;
+
+    System::Doorbell &db = system->doorbells[cid];
+    assert(!db.arming && !db.waiting);
+    db.arming = true;
+    db.armed = true;
+    db.rang = false;
+    system->doorbellArmers[cid](paddr);
+    tc->suspend();
+}
+
+void
+Process::doorbellWait(ThreadContext *tc)
+{
+    auto lock = system->sharedStateLock();
+    System::Doorbell &db = system->doorbells[tc->contextId()];
+    if (db.rang || !db.armed) {
+        // rung since the arm, or nothing to wait for
+        db.rang = false;
+        db.armed = false;
+        return;
+    }
+    db.waiting = true;
+    db.waitStart = curTick();
+    tc->suspend();
+}
+
+int
+Process::doorbellReady(ThreadContext *tc)
+{
+    auto lock = system->sharedStateLock();
+    auto it = system->doorbells.find(tc->contextId());
+    return it == system->doorbells.end() ||
+           (!it->second.arming && !it->second.waiting);
+}
+
+void
+Process::doorbellArmed(ThreadContext *tc)
+{
+    auto lock = system->sharedStateLock();
+    System::Doorbell &db = system->doorbells[tc->contextId()];
+    assert(db.arming);
+    db.arming = false;
+    system->wakeupContext(tc);
+}
+
+void
+Process::doorbellRang(ThreadContext *tc)
+{
+    auto lock = system->sharedStateLock();
+    System::Doorbell &db = system->doorbells[tc->contextId()];
+    db.armed = false;
+    if (!db.waiting) {
+        // the caller is still between arm and wait
+        db.rang = true;
+        return;
+    }
+    db.waiting = false;
+    numDoorbellWakeups++;
+    doorbellWaitTicks.sample(curTick() - db.waitStart);
+    system->wakeupContext(tc);
+}
+
+void
+Process::monitorArm(Addr vaddr, ThreadContext *tc)
+{
+    Addr paddr;
+    {
+        auto lock = system->sharedStateLock();
+        ContextID cid = tc->contextId();
+        // same fallback as doorbellArm: mwait returns at once
+        if (!system->isTimingMode() ||
+            system->monitorSetters.size() <= (size_t)cid ||
+            !system->monitorSetters[cid] || !pTable->translate(vaddr, paddr))
+            return;
+
+        System::Monitor &mon = system->monitors[cid];
+        assert(!mon.waiting);
+        mon.armed = true;
+        mon.triggered = false;
+        system->monitorSetters[cid](paddr);
+    }
+
+    // readers never cache ST_REL lines, so there is no invalidation to
+    // observe; watch the release at the home L2 instead
+    if (isSTRELVaddrRange(paddr))
+        doorbellArm(vaddr, tc);
+}
+
+void
+Process::mwait(Cycles timeout, ThreadContext *tc)
+{
+    auto lock = system->sharedStateLock();
+    System::Monitor &mon = system->monitors[tc->contextId()];
+    if (mon.triggered || !mon.armed) {
+        // triggered since the monitor, or nothing to wait for
+        mon.triggered = false;
+        return;
+    }
+    mon.waiting = true;
+    mon.waitStart = curTick();
+    if (timeout > 0) {
+        if (!mon.timeout) {
+            mon.timeout = new EventFunctionWrapper([this, tc] {
+                auto lock = system->sharedStateLock();
+                System::Monitor &mon = system->monitors[tc->contextId()];
+                assert(mon.waiting);
+                mon.armed = false;
+                mon.waiting = false;
+                numMwaitTimeouts++;
+                mwaitTicks.sample(curTick() - mon.waitStart);
+                system->wakeupContext(tc);
+            }, name() + ".mwaitTimeout");
+        }
+        BaseCPU *cpu = tc->getCpuPtr();
+        cpu->schedule(mon.timeout, cpu->clockEdge(timeout));
+    }
+    tc->suspend();
+}
+
+int
+Process::mwaitReady(ThreadContext *tc)
+{
+    if (!doorbellReady(tc))
+        return false;
+    auto lock = system->sharedStateLock();
+    auto it = system->monitors.find(tc->contextId());
+    return it == system->monitors.end() || !it->second.waiting;
+}
+
+void
+Process::monitorTriggered(ThreadContext *tc)
+{
+    auto lock = system->sharedStateLock();
+    System::Monitor &mon = system->monitors[tc->contextId()];
+    if (!mon.armed) {
+        // stale: the mwait already timed out
+        return;
+    }
+    mon.armed = false;
+    if (!mon.waiting) {
+        mon.triggered = true;
+        return;
+    }
+    mon.waiting = false;
+    // the L1 and the CPU share an event queue, see TwoMeshXY.partition
+    if (mon.timeout && mon.timeout->scheduled())
+        tc->getCpuPtr()->deschedule(mon.timeout);
+    numMwaitWakeups++;
+    mwaitTicks.sample(curTick() - mon.waitStart);
+    system->wakeupContext(tc);
 }
 
 ThreadContext *
@@ -319,10 +618,20 @@ Process::drain()
     return DrainState::Drained;
 }
 
+std::unique_lock<std::mutex>
+Process::pageTableLock()
+{
+    panic_if(system->handoffActive(),
+             "%s: page table changed inside the ROI outside a handoff\n",
+             name());
+    return system->sharedStateLock();
+}
+
 void
 Process::allocateMem(Addr vaddr, int64_t size, bool clobber)
 {
     // DPRINTF(RRC, "in allocateMem\n");
+    auto lock = pageTableLock();
     int npages = divCeil(size, (int64_t)PageBytes);
     Addr paddr = system->allocPhysPages(npages);
     pTable->map(vaddr, paddr, size,
@@ -334,6 +643,7 @@ void
 Process::allocateMemThreadCtx(Addr vaddr, int64_t size, bool clobber, ThreadContext *tc)
 {
     // DPRINTF(RRC, "in allocateMemThreadCtx\n");
+    auto lock = pageTableLock();
     int npages = divCeil(size, (int64_t)PageBytes);
     Addr paddr = system->allocPhysPagesThreadCtx(npages, tc);
     pTable->map(vaddr, paddr, size,
@@ -345,6 +655,7 @@ void
 Process::replicatePage(Addr vaddr, Addr new_paddr, ThreadContext *old_tc,
                        ThreadContext *new_tc, bool allocate_page)
 {
+    auto lock = pageTableLock();
     if (allocate_page)
         new_paddr = system->allocPhysPages(1);
 
@@ -422,11 +733,89 @@ Process::fixupStackFaultThreadCtx(Addr vaddr, ThreadContext *tc)
     return false;
 }
 
+void
+DOVaddrRanges::add(Addr begin, Addr end)
+{
+    if (begin >= end)
+        return;
+    // a range registered twice is kept once; ranges are never merged
+    Addr &range_end = ranges[begin];
+    range_end = std::max(range_end, end);
+}
+
+void
+DOVaddrRanges::remove(Addr begin, Addr end)
+{
+    if (begin >= end)
+        return;
+    // ranges may overlap, so any range starting before end can be hit
+    auto it = ranges.begin();
+    while (it != ranges.end() && it->first < end) {
+        Addr range_begin = it->first;
+        Addr range_end = it->second;
+        if (range_end <= begin) {
+            ++it;
+            continue;
+        }
+        it = ranges.erase(it);
+        // keep the parts outside [begin, end); both lie in the range that
+        // was registered, so they stay physically contiguous
+        if (range_begin < begin)
+            add(range_begin, begin);
+        if (range_end > end)
+            add(end, range_end);
+    }
+}
+
+void
+DOVaddrRanges::serialize(const std::string &base, CheckpointOut &cp) const
+{
+    std::vector<Addr> range_begins, range_ends;
+    for (const auto &range : ranges) {
+        range_begins.push_back(range.first);
+        range_ends.push_back(range.second);
+    }
+    arrayParamOut(cp, base + "_range_begin", range_begins);
+    arrayParamOut(cp, base + "_range_end", range_ends);
+}
+
+void
+DOVaddrRanges::unserialize(const std::string &base, CheckpointIn &cp)
+{
+    std::vector<Addr> range_begins, range_ends;
+    arrayParamIn(cp, base + "_range_begin", range_begins);
+    arrayParamIn(cp, base + "_range_end", range_ends);
+    assert(range_begins.size() == range_ends.size());
+    ranges.clear();
+    for (size_t i = 0; i < range_begins.size(); ++i)
+        ranges[range_begins[i]] = range_ends[i];
+}
+
+bool
+Process::inDOVaddrRanges(const DOVaddrRanges &ranges, Addr paddr)
+{
+    Addr begin_paddr, end_paddr;
+    for (const auto &range : ranges.get()) {
+        Addr begin_vaddr = range.first;
+        Addr end_vaddr = (range.second - 1); // -1 is a must
+        // a range that is not (or no longer) mapped matches nothing
+        if (!pTable->translate(begin_vaddr, begin_paddr) ||
+            !pTable->translate(end_vaddr, end_paddr))
+            continue;
+        if (paddr >= begin_paddr && paddr < end_paddr)
+            return true;
+    }
+    return false;
+}
+
 void
 Process::serialize(CheckpointOut &cp) const
 {
     memState->serialize(cp);
     pTable->serialize(cp);
+    // DO address ranges registered through the STNT/STREL CSRs
+    stntRanges->serialize("stnt", cp);
+    strelRanges->serialize("strel", cp);
     /**
      * Checkpoints for file descriptors currently do not work. Need to
      * come back and fix them at a later date.
@@ -445,6 +834,21 @@ Process::unserialize(CheckpointIn &cp)
 {
     memState->unserialize(cp);
     pTable->unserialize(cp);
+    if (cp.entryExists(Serializable::currentSection(), "stnt_range_begin")) {
+        stntRanges->unserialize("stnt", cp);
+        strelRanges->unserialize("strel", cp);
+    } else {
+        // --brg-checkpoint-roi checkpoints kept the ranges in the system
+        // section. Restoring them without the ranges would silently run
+        // a non-DO system, so refuse instead.
+        std::string old_begins;
+        if ((cp.find(system->name(), "stnt_range_begin", old_begins) &&
+             !old_begins.empty()) ||
+            (cp.find(system->name(), "strel_range_begin", old_begins) &&
+             !old_begins.empty()))
+            fatal("%s: checkpoint keeps the STNT/STREL ranges in the system "
+                  "section; retake it with --brg-checkpoint-roi\n", name());
+    }
     /**
      * Checkpoints for file descriptors currently do not work. Need to
      * come back and fix them at a later date.
@@ -464,21 +868,55 @@ Process::unserialize(CheckpointIn &cp)
 bool
 Process::map(Addr vaddr, Addr paddr, int size, bool cacheable)
 {
+    auto lock = pageTableLock();
     pTable->map(vaddr, paddr, size,
                 cacheable ? EmulationPageTable::MappingFlags(0) :
                             EmulationPageTable::Uncacheable);
     return true;
 }
 
+// the syscalls that change the page table
+static bool
+changesPageTable(SyscallDesc *desc)
+{
+    static const std::set<std::string> names = {
+        "brk", "clone", "mmap", "mmap2", "mremap", "munmap"
+    };
+    return names.count(desc->name());
+}
+
 void
 Process::syscall(int64_t callnum, ThreadContext *tc, Fault *fault)
 {
+    ContextID cid = tc->contextId();
+    if (system->handoffQuantum > 0) {
+        auto lock = system->sharedStateLock();
+        // back from the handoff below, which has run the syscall
+        if (handedOffSyscalls.erase(cid))
+            return;
+    }
+
     numSyscalls++;
 
     SyscallDesc *desc = getDesc(callnum);
     if (desc == nullptr)
         fatal("Syscall %d out of range", callnum);
 
+    if (system->handoffActive() && changesPageTable(desc)) {
+        // run it at the handoff, which sets the return value, then
+        // re-execute the ecall to move past it
+        system->handOff(cid, curTick(), [this, desc, callnum, cid] {
+            ThreadContext *tc = system->getThreadContext(cid);
+            Fault fault = NoFault;
+            desc->doSyscall(callnum, this, tc, &fault);
+            handedOffSyscalls.insert(cid);
+            tc->activate();
+        });
+        tc->suspend();
+        *fault = std::make_shared<SyscallRetryFault>();
+        return;
+    }
+
     desc->doSyscall(callnum, this, tc, fault);
 }
 
@@ -50,6 +50,8 @@
 #include <inttypes.h>
 
 #include <map>
+#include <memory>
+#include <set>
 #include <string>
 #include <vector>
 #include <utility>
@@ -71,6 +73,30 @@
 
 struct ProcessParams;
 
+/**
+ * Virtual address ranges registered through the STNT/STREL CSRs, sorted
+ * by begin address. Each registered range is kept on its own: ranges are
+ * matched by the physical span of their first and last page, and two
+ * buffers that are adjacent in vaddr need not be in paddr (SE mmap grows
+ * down while physical pages are handed out upward). The threads of one
+ * address space share them, see Process::clone.
+ */
+class DOVaddrRanges
+{
+  public:
+    void add(Addr begin, Addr end);
+    void remove(Addr begin, Addr end);
+
+    // begin -> end, end exclusive
+    const std::map<Addr, Addr> &get() const { return ranges; }
+
+    void serialize(const std::string &base, CheckpointOut &cp) const;
+    void unserialize(const std::string &base, CheckpointIn &cp);
+
+  private:
+    std::map<Addr, Addr> ranges;
+};
+
 class EmulatedDriver;
 class ObjectFile;
 class EmulationPageTable;
@@ -132,32 +158,44 @@ class Process : public SimObject
     // override of virtual SimObject method: register statistics
     void regStats() override;
 
+    /**
+     * Lock for changing the page table, see System::sharedStateLock. The
+     * DO range lookups of the sequencers translate under it. The CPUs'
+     * own translations do not, so in the ROI of a --parallel-nodes run
+     * the changes wait for a handoff (System::handoffQuantum).
+     */
+    std::unique_lock<std::mutex> pageTableLock();
+
     void allocateMem(Addr vaddr, int64_t size, bool clobber = false);
     void allocateMemThreadCtx(Addr vaddr, int64_t size, bool clobber = false, ThreadContext *tc = nullptr);
 
-    void barrierInit(uint64_t n_threads) {
-      system->n_barrier_waiters = n_threads;
-      system->n_barrier_in = 0;
-      system->n_barrier_out = 0;
-    }
-
-    void barrierWait(uint64_t bar_id) {
-      ++(system->n_barrier_in);
-      assert(system->n_barrier_in <= system->n_barrier_waiters);
-    }
-  
-    int barrierReady(int cpu_id) {
-      if (system->n_barrier_in == system->n_barrier_waiters) {
-        ++(system->n_barrier_out);
-        if (system->n_barrier_out == system->n_barrier_waiters) {
-          system->n_barrier_in = 0;
-          system->n_barrier_out = 0;          
-        }
-        return 1;
-      } else {
-        return 0;
-      }
+    // sets the waiter count of every barrier id without its own count
+    void barrierInit(uint64_t n_threads);
+    // sets the waiter count of the id last written to CSR_BARRIER_ID
+    void barrierInitId(uint64_t n_threads, int cpu_id);
+    void registerBarrierId(uint64_t bar_id, int cpu_id) {
+      barrier_init_id[cpu_id] = bar_id;
     }
+    // suspends tc until all waiters arrived at bar_id
+    void barrierWait(uint64_t bar_id, ThreadContext *tc);
+    int barrierReady(ThreadContext *tc);
+
+    // suspends tc until the home L2 registered a watch on vaddr's line
+    void doorbellArm(Addr vaddr, ThreadContext *tc);
+    // suspends tc until the armed line commits a ST_REL
+    void doorbellWait(ThreadContext *tc);
+    int doorbellReady(ThreadContext *tc);
+    // callbacks from the L1 of tc's core
+    void doorbellArmed(ThreadContext *tc);
+    void doorbellRang(ThreadContext *tc);
+
+    // watches paddr's line in tc's L1; ST_REL lines also arm a doorbell
+    void monitorArm(Addr vaddr, ThreadContext *tc);
+    // suspends tc until the monitor triggers or timeout cycles (0: none)
+    void mwait(Cycles timeout, ThreadContext *tc);
+    int mwaitReady(ThreadContext *tc);
+    // callback from the L1 of tc's core
+    void monitorTriggered(ThreadContext *tc);
 
     void registerSTNTBeginVaddr(Addr vaddr_begin, int cpu_id) {
       stnt_begin_vaddr[cpu_id] = vaddr_begin;
@@ -165,9 +203,16 @@ class Process : public SimObject
     }
   
     void registerSTNTEndVaddr(Addr vaddr_end, int cpu_id) {
-      system->STNTVaddrRanges.emplace_back(std::make_pair(stnt_begin_vaddr[cpu_id], vaddr_end));
+      auto lock = system->sharedStateLock();
+      stntRanges->add(stnt_begin_vaddr[cpu_id], vaddr_end);
       // DPRINTF(DOMEM, "register stnt range vaddr[0x%0llx-0x%llx]\n", stnt_begin_vaddr, vaddr_end);
     }
+
+    // the begin of an unregistered range comes from the begin CSR too
+    void unregisterSTNTEndVaddr(Addr vaddr_end, int cpu_id) {
+      auto lock = system->sharedStateLock();
+      stntRanges->remove(stnt_begin_vaddr[cpu_id], vaddr_end);
+    }
   
     void registerSTRELBeginVaddr(Addr vaddr_begin, int cpu_id) {
       strel_begin_vaddr[cpu_id] = vaddr_begin;      
@@ -175,62 +220,31 @@ class Process : public SimObject
     }
   
     void registerSTRELEndVaddr(Addr vaddr_end, int cpu_id) {
-      system->STRELVaddrRanges.emplace_back(std::make_pair(strel_begin_vaddr[cpu_id], vaddr_end));   
+      auto lock = system->sharedStateLock();
+      strelRanges->add(strel_begin_vaddr[cpu_id], vaddr_end);
       // DPRINTF(DOMEM, "register strel range vaddr[0x%0llx-0x%llx]\n", strel_begin_vaddr, vaddr_end);   
     }
 
+    void unregisterSTRELEndVaddr(Addr vaddr_end, int cpu_id) {
+      auto lock = system->sharedStateLock();
+      strelRanges->remove(strel_begin_vaddr[cpu_id], vaddr_end);
+    }
+
     bool isSTNTVaddrRange(Addr paddr) {
-      Addr begin_paddr, end_paddr;
-      for (auto range : system->STNTVaddrRanges) {
-        Addr begin_vaddr = range.first;
-        Addr end_vaddr = (range.second - 1); // -1 is a must
-        if (!pTable->translate(begin_vaddr, begin_paddr)) {
-          // panic("stnt quirying unmapped vaddr[0x%x]\n", begin_vaddr);
-          return false;
-        } else {
-          // begin_paddr += (begin_vaddr % TheISA::PageBytes);
-          if (!pTable->translate(end_vaddr, end_paddr)) {
-            // panic("stnt quirying unmapped vaddr[0x%x]\n", end_vaddr);
-            return false;
-          } else {
-            // end_paddr += (end_vaddr % TheISA::PageBytes);
-            // DPRINTF(DOMEM, "stnt check paddr[0x%llx] for range v[0x%llx-0x%llx], p[0x%llx-0x%llx]\n",
-              // paddr, begin_vaddr, end_vaddr, begin_paddr, end_paddr);
-            if (paddr >= begin_paddr && paddr < end_paddr) {
-              return true;
-            }
-          }
-        }
-      }
-      return false;
+      auto lock = system->sharedStateLock();
+      return inDOVaddrRanges(*stntRanges, paddr);
     }
 
     bool isSTRELVaddrRange(Addr paddr) {
-      Addr begin_paddr, end_paddr;
-      for (auto range : system->STRELVaddrRanges) {
-        Addr begin_vaddr = range.first;
-        Addr end_vaddr = (range.second - 1); // -1 is a must
-        if (!pTable->translate(begin_vaddr, begin_paddr)) {
-          // panic("strel quirying unmapped vaddr[0x%x]\n", begin_vaddr);
-          return false;
-        } else {
-          // begin_paddr += (begin_vaddr % TheISA::PageBytes);
-          if (!pTable->translate(end_vaddr, end_paddr)) {
-            // panic("strel quirying unmapped vaddr[0x%x]\n", end_vaddr);
-            return false;
-          } else {
-            // end_paddr += (end_vaddr % TheISA::PageBytes);
-            // DPRINTF(DOMEM, "strel check paddr[0x%llx] for range v[0x%llx-0x%llx], p[0x%llx-0x%llx]\n",
-              // paddr, begin_vaddr, end_vaddr, begin_paddr, end_paddr);
-            if (paddr >= begin_paddr && paddr < end_paddr) {
-              return true;
-            }
-          }
-        }
-      }
-      return false;
+      auto lock = system->sharedStateLock();
+      return inDOVaddrRanges(*strelRanges, paddr);
     }
 
+  private:
+    // whether paddr falls in the physical span of a range in ranges
+    bool inDOVaddrRanges(const DOVaddrRanges &ranges, Addr paddr);
+
+  public:
     /// Attempt to fix up a fault at vaddr by allocating a page on the stack.
     /// @return Whether the fault has been fixed.
     bool fixupStackFault(Addr vaddr);
@@ -287,8 +301,28 @@ class Process : public SimObject
     // system object which owns this process
     System *system;
 
+    // contexts whose page-table syscall has run at a handoff and which
+    // have yet to re-execute it, see syscall()
+    std::set<ContextID> handedOffSyscalls;
+
     Stats::Scalar numSyscalls;  // track how many system calls are executed
 
+    // gem5 barrier stats
+    Stats::Scalar numBarriers;
+    Stats::Histogram barrierWaitTicks;
+    // ids from maxBarrierStatIds on share the last bucket
+    static const uint64_t maxBarrierStatIds = 1024;
+    Stats::Vector barrierWaitTicksPerId;
+
+    // doorbell stats
+    Stats::Scalar numDoorbellWakeups;
+    Stats::Histogram doorbellWaitTicks;
+
+    // monitor/mwait stats
+    Stats::Scalar numMwaitWakeups;
+    Stats::Scalar numMwaitTimeouts;
+    Stats::Histogram mwaitTicks;
+
     bool useArchPT; // flag for using architecture specific page table
     bool kvmInSE;   // running KVM requires special initialization
 
@@ -298,6 +332,9 @@ class Process : public SimObject
 
     std::map<int, Addr> stnt_begin_vaddr;
     std::map<int, Addr> strel_begin_vaddr;
+    std::map<int, uint64_t> barrier_init_id;
+    std::shared_ptr<DOVaddrRanges> stntRanges;
+    std::shared_ptr<DOVaddrRanges> strelRanges;
 
     ObjectFile *objFile;
     std::vector<std::string> argv;
@@ -1214,7 +1214,10 @@ mremapFunc(SyscallDesc *desc, int callnum, Process *process, ThreadContext *tc)
                     mem_state->setMmapEnd(mmap_end);
                 }
 
-                process->pTable->remap(start, old_length, new_start);
+                {
+                    auto lock = process->pageTableLock();
+                    process->pTable->remap(start, old_length, new_start);
+                }
                 warn("mremapping to new vaddr %08p-%08p, adding %d\n",
                      new_start, new_start + new_length,
                      new_length - old_length);
@@ -1236,6 +1239,7 @@ mremapFunc(SyscallDesc *desc, int callnum, Process *process, ThreadContext *tc)
             }
         }
     } else {
+        auto lock = process->pageTableLock();
         if (use_provided_address && provided_address != start)
             process->pTable->remap(start, new_length, provided_address);
         process->pTable->unmap(start + new_length, old_length - new_length);
@@ -1625,7 +1629,7 @@ cloneFunc(SyscallDesc *desc, int callnum, Process *p, ThreadContext *tc)
     // when a process is initialized, a thread context may have been already
     // activated, so we don't want to activate it twice.
     if (ctc->status() != ThreadContext::Active)
-        ctc->activate();
+        tc->getSystemPtr()->wakeupContext(ctc);
 
     return cp->pid();
 }
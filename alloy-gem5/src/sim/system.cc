@@ -84,6 +84,7 @@
 #include "sim/byteswap.hh"
 #include "sim/debug.hh"
 #include "sim/full_system.hh"
+#include "sim/global_event.hh"
 
 /**
  * To avoid linking errors with LTO, only include the header if we
@@ -111,6 +112,8 @@ System::System(Params *p)
       kernel(nullptr),
       loadAddrMask(p->load_addr_mask),
       loadAddrOffset(p->load_offset),
+      handoffQuantum(p->handoff_quantum),
+      inHandoff(false),
 #if USE_KVM
       kvmVM(p->kvm_vm),
 #else
@@ -127,6 +130,7 @@ System::System(Params *p)
       totalNumInsts(0),
       instEventQueue("system instruction-based event queue"),
       brg_fast_forward(p->brg_fast_forward),
+      brg_roi_phase(BrgROIPhase::Before),
       num_nodes(p->num_nodes),
       num_cores(p->num_cores)
 {
@@ -230,6 +234,9 @@ System::~System()
 
     for (uint32_t j = 0; j < numWorkIds; j++)
         delete workItemStats[j];
+
+    for (auto &slot : handoffEvents)
+        delete slot.second;
 }
 
 void
@@ -468,6 +475,89 @@ System::isMemAddr(Addr addr) const
     return physmem.isMemAddr(addr);
 }
 
+class System::HandoffEvent : public GlobalEvent
+{
+  public:
+    struct Request
+    {
+        Tick when;
+        ContextID cid;
+        std::function<void()> op;
+    };
+    std::vector<Request> requests;
+
+    // ahead of everything else at that tick, like a CPU switch
+    HandoffEvent(System *_system, Tick when)
+        : GlobalEvent(when, Event::CPU_Switch_Pri, 0), system(_system)
+    {}
+
+    void
+    process() override
+    {
+        // every other queue waits at the barrier meanwhile
+        std::sort(requests.begin(), requests.end(),
+                  [](const Request &a, const Request &b) {
+                      return a.when != b.when ? a.when < b.when :
+                                                a.cid < b.cid;
+                  });
+        system->inHandoff = true;
+        for (auto &req : requests) {
+            BaseCPU *cpu = system->getThreadContext(req.cid)->getCpuPtr();
+            EventQueue::ScopedMigration migrate(cpu->eventQueue());
+            req.op();
+        }
+        system->inHandoff = false;
+        requests.clear();
+    }
+
+    const char *description() const override { return "SE state handoff"; }
+
+  private:
+    System *system;
+};
+
+void
+System::handOff(ContextID cid, Tick when, std::function<void()> op)
+{
+    std::lock_guard<std::mutex> lock(handoffMutex);
+
+    // when is in the current quantum or later, and so are the ticks of
+    // the other queues, so the slot is past all of them
+    Tick slot = (when / handoffQuantum + 2) * handoffQuantum;
+
+    // a slot more than a quantum ago has been left by every queue
+    while (!handoffEvents.empty() &&
+           handoffEvents.begin()->first + handoffQuantum < curTick()) {
+        delete handoffEvents.begin()->second;
+        handoffEvents.erase(handoffEvents.begin());
+    }
+
+    HandoffEvent *&event = handoffEvents[slot];
+    if (!event)
+        event = new HandoffEvent(this, slot);
+    event->requests.push_back({when, cid, std::move(op)});
+}
+
+void
+System::wakeupContext(ThreadContext *tc, Tick when)
+{
+    if (handoffActive()) {
+        ContextID cid = tc->contextId();
+        handOff(cid, when, [this, cid] { getThreadContext(cid)->activate(); });
+        return;
+    }
+
+    EventQueue *eventq = tc->getCpuPtr()->eventQueue();
+    if (eventq == curEventQueue()) {
+        tc->activate();
+        return;
+    }
+    eventq->schedule(new EventFunctionWrapper([tc] { tc->activate(); },
+                                              name() + ".wakeupContext",
+                                              true),
+                     curTick() + simQuantum);
+}
+
 void
 System::drainResume()
 {
@@ -483,6 +573,48 @@ System::serialize(CheckpointOut &cp) const
     SERIALIZE_CONTAINER(pagePtrs);
     serializeSymtab(cp);
 
+    for (auto &slot : handoffEvents)
+        fatal_if(!slot.second->requests.empty(),
+                 "%s: checkpoint taken with a handoff pending\n", name());
+    // the watches live in the L1s and L2s, which do not checkpoint them
+    for (auto &db : doorbells)
+        fatal_if(db.second.arming || db.second.armed || db.second.waiting,
+                 "%s: checkpoint taken with a doorbell armed\n", name());
+    for (auto &mon : monitors)
+        fatal_if(mon.second.armed || mon.second.waiting,
+                 "%s: checkpoint taken with a monitor armed\n", name());
+
+    // a checkpoint taken at the start of the ROI must resume inside it
+    paramOut(cp, "brg_roi_phase", static_cast<int>(brg_roi_phase));
+
+    // threads suspended in a gem5 barrier, flattened in barrier order
+    std::vector<uint64_t> bar_ids, bar_n_waiters;
+    std::vector<ContextID> waiter_ctxs;
+    std::vector<Tick> waiter_arrivals;
+    for (const auto &bar : barriers) {
+        for (const auto &waiter : bar.second.waiters) {
+            bar_ids.push_back(bar.first);
+            bar_n_waiters.push_back(bar.second.n_waiters);
+            waiter_ctxs.push_back(waiter.tc->contextId());
+            waiter_arrivals.push_back(waiter.arrival);
+        }
+    }
+    std::vector<uint64_t> init_ids, init_n_waiters;
+    for (const auto &count : barrierIdWaiters) {
+        init_ids.push_back(count.first);
+        init_n_waiters.push_back(count.second);
+    }
+    SERIALIZE_SCALAR(n_barrier_waiters);
+    arrayParamOut(cp, "barrier_init_id", init_ids);
+    arrayParamOut(cp, "barrier_init_n_waiters", init_n_waiters);
+    arrayParamOut(cp, "barrier_id", bar_ids);
+    arrayParamOut(cp, "barrier_n_waiters", bar_n_waiters);
+    arrayParamOut(cp, "barrier_waiter_ctx", waiter_ctxs);
+    arrayParamOut(cp, "barrier_waiter_arrival", waiter_arrivals);
+    std::vector<ContextID> pending(barrierPending.begin(),
+                                   barrierPending.end());
+    arrayParamOut(cp, "barrier_pending", pending);
+
     // also serialize the memories in the system
     physmem.serializeSection(cp, "physmem");
 }
@@ -497,6 +629,55 @@ System::unserialize(CheckpointIn &cp)
     UNSERIALIZE_CONTAINER(pagePtrs);
     unserializeSymtab(cp);
 
+    // the brg state below is absent from checkpoints that predate it
+    int roi_phase;
+    if (optParamIn(cp, "brg_roi_phase", roi_phase)) {
+        brg_roi_phase = static_cast<BrgROIPhase>(roi_phase);
+
+        // suspended waiters map back onto the restored thread contexts
+        std::vector<uint64_t> bar_ids, bar_n_waiters;
+        std::vector<ContextID> waiter_ctxs;
+        std::vector<Tick> waiter_arrivals;
+        std::vector<ContextID> pending;
+        UNSERIALIZE_SCALAR(n_barrier_waiters);
+        arrayParamIn(cp, "barrier_id", bar_ids);
+        arrayParamIn(cp, "barrier_waiter_ctx", waiter_ctxs);
+        arrayParamIn(cp, "barrier_waiter_arrival", waiter_arrivals);
+        arrayParamIn(cp, "barrier_pending", pending);
+        // per-id waiter counts are newer than the rest of this state
+        barrierIdWaiters.clear();
+        if (cp.entryExists(Serializable::currentSection(),
+                           "barrier_n_waiters")) {
+            std::vector<uint64_t> init_ids, init_n_waiters;
+            arrayParamIn(cp, "barrier_init_id", init_ids);
+            arrayParamIn(cp, "barrier_init_n_waiters", init_n_waiters);
+            for (size_t i = 0; i < init_ids.size(); ++i)
+                barrierIdWaiters[init_ids[i]] = init_n_waiters[i];
+            arrayParamIn(cp, "barrier_n_waiters", bar_n_waiters);
+        } else {
+            bar_n_waiters.assign(bar_ids.size(), n_barrier_waiters);
+        }
+        barriers.clear();
+        for (size_t i = 0; i < bar_ids.size(); ++i) {
+            Barrier &bar = barriers[bar_ids[i]];
+            bar.n_waiters = bar_n_waiters[i];
+            bar.waiters.push_back(
+                BarrierWaiter{getThreadContext(waiter_ctxs[i]),
+                              waiter_arrivals[i]});
+        }
+        barrierPending.clear();
+        barrierPending.insert(pending.begin(), pending.end());
+    }
+
+    // CPUs restored inside the ROI never see the STATS_EN write that
+    // opened it, so turn their ROI stats on here
+    if (brg_roi_phase == BrgROIPhase::Inside) {
+        for (auto *tc : threadContexts) {
+            tc->getCpuPtr()->global_stats_en = true;
+            tc->getCpuPtr()->toggle_stats_en(true);
+        }
+    }
+
     // also unserialize the memories in the system
     physmem.unserializeSection(cp, "physmem");
 }
@@ -60,8 +60,12 @@
 #ifndef __SYSTEM_HH__
 #define __SYSTEM_HH__
 
+#include <functional>
+#include <map>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -76,6 +80,7 @@
 #include "mem/port.hh"
 #include "mem/port_proxy.hh"
 #include "params/System.hh"
+#include "sim/eventq.hh"
 #include "sim/futex_map.hh"
 #include "sim/se_signal.hh"
 
@@ -314,14 +319,159 @@ class System : public MemObject
      */
     ThermalModel * getThermalModel() const { return thermalModel; }
 
-    std::vector<std::pair<Addr, Addr>> STNTVaddrRanges;
-    std::vector<std::pair<Addr, Addr>> STRELVaddrRanges;
+    // gem5 barriers (CSR_BARRIER_*). Waiters are suspended until the last
+    // of the barrier's n_waiters threads arrives at the same barrier id.
+    // n_waiters is fixed by the first arrival: the id's entry in
+    // barrierIdWaiters (CSR_BARRIER_ID_INIT), else n_barrier_waiters.
+    struct BarrierWaiter
+    {
+        ThreadContext *tc;
+        Tick arrival;
+    };
+    struct Barrier
+    {
+        uint64_t n_waiters;
+        std::vector<BarrierWaiter> waiters;
+    };
     uint64_t n_barrier_waiters;
-    uint64_t n_barrier_in;
-    uint64_t n_barrier_out;
+    std::unordered_map<uint64_t, uint64_t> barrierIdWaiters;
+    std::unordered_map<uint64_t, Barrier> barriers;
+    std::unordered_set<ContextID> barrierPending;
+
+    // doorbells (CSR_DOORBELL_*). A thread arms a watch on a ST_REL line
+    // and sleeps until the line's L2 commits the next release to it.
+    struct Doorbell
+    {
+        bool arming = false;  // waiting for the L2 to ack the watch
+        bool armed = false;   // watch registered and not rung yet
+        bool waiting = false; // suspended in CSR_DOORBELL_WAIT
+        bool rang = false;    // rung before the thread went to sleep
+        Tick waitStart = 0;
+    };
+    std::unordered_map<ContextID, Doorbell> doorbells;
+    // per-context hook into the L1 that sends the watch to the home L2,
+    // installed by DOSequencer; empty for protocols without doorbells
+    std::vector<std::function<void(Addr)>> doorbellArmers;
+
+    void
+    registerDoorbellArmer(ContextID cid, std::function<void(Addr)> armer)
+    {
+        if (doorbellArmers.size() <= (size_t)cid)
+            doorbellArmers.resize(cid + 1);
+        doorbellArmers[cid] = armer;
+    }
+
+    // monitor/mwait (CSR_MONITOR, CSR_MWAIT). A thread sleeps until its
+    // L1 loses the monitored line, the line's doorbell rings or the
+    // timeout expires.
+    struct Monitor
+    {
+        bool armed = false;     // monitor set and not triggered yet
+        bool triggered = false; // triggered before the thread went to sleep
+        bool waiting = false;   // suspended in CSR_MWAIT
+        Tick waitStart = 0;
+        EventFunctionWrapper *timeout = nullptr;
+    };
+    std::unordered_map<ContextID, Monitor> monitors;
+    // per-context hook that tells the L1 which line to monitor, installed
+    // together with the doorbell armer
+    std::vector<std::function<void(Addr)>> monitorSetters;
+
+    void
+    registerMonitorSetter(ContextID cid, std::function<void(Addr)> setter)
+    {
+        if (monitorSetters.size() <= (size_t)cid)
+            monitorSetters.resize(cid + 1);
+        monitorSetters[cid] = setter;
+    }
+
+    // per-hart DO event counters, read by the hart itself through
+    // CSR_DOCNT_* to break a run into phases without dumping stats. They
+    // only ever count up; software takes differences.
+    struct DOCounters
+    {
+        uint64_t stnt = 0;             // ST_NTs issued
+        uint64_t strel = 0;            // ST_RELs issued
+        Tick acqStallTicks = 0;        // LD_ACQ issue to data
+        Tick relLatencyTicks = 0;      // ST_REL issue to its ack
+        Tick barrierWaitTicks = 0;     // time spent in CSR_BARRIER_WAIT
+    };
+    std::vector<DOCounters> hartCounters;
+
+    // sized up front by the sequencers so the per-node event queues never
+    // resize the vector underneath each other
+    void
+    registerDOCounters(ContextID cid)
+    {
+        if (hartCounters.size() <= (size_t)cid)
+            hartCounters.resize(cid + 1);
+    }
+
+    DOCounters &
+    doCounters(ContextID cid)
+    {
+        registerDOCounters(cid);
+        return hartCounters[cid];
+    }
+
+    /**
+     * Lock for the barriers, doorbells and monitors above, and for the
+     * processes' DO ranges, when the CPUs run on several event queues
+     * (--parallel-nodes). Serial runs skip the lock.
+     */
+    std::unique_lock<std::mutex>
+    sharedStateLock()
+    {
+        return numMainEventQueues > 1 ?
+            std::unique_lock<std::mutex>(sharedStateMutex) :
+            std::unique_lock<std::mutex>();
+    }
+
+    /**
+     * Activate a suspended thread context. A context simulated by another
+     * event queue is activated one simulation quantum later, the earliest
+     * time its queue can safely take the event. Inside the ROI with a
+     * handoff quantum the wake-up goes through handOff(), as of @p when.
+     */
+    void wakeupContext(ThreadContext *tc, Tick when = curTick());
+
+    /**
+     * The node threads of a --parallel-nodes run translate through the SE
+     * page table without a lock, and the order in which they take the
+     * shared state lock above depends on the host. So inside the ROI the
+     * page-table syscalls, stack growth and wake-ups are not done in
+     * place: the context suspends and the change runs at the next handoff
+     * slot, a multiple of handoffQuantum more than one quantum after the
+     * request. Every queue stops there, and the changes run one after the
+     * other on the queue of their context, in (request tick, context id)
+     * order. A serial run with the same quantum (--parallel-reference)
+     * does the same, so the two can be compared stat for stat.
+     */
+    const Tick handoffQuantum;
+
+    bool
+    handoffActive() const
+    {
+        return handoffQuantum > 0 && !inHandoff &&
+               brg_roi_phase == BrgROIPhase::Inside;
+    }
+
+    /**
+     * Run op at the handoff slot for a request made at @p when by (or for)
+     * context cid. The caller suspends the context; op wakes it up.
+     */
+    void handOff(ContextID cid, Tick when, std::function<void()> op);
 
   protected:
 
+    std::mutex sharedStateMutex;
+
+    class HandoffEvent;
+    // pending and recently run slots, see handOff()
+    std::map<Tick, HandoffEvent *> handoffEvents;
+    std::mutex handoffMutex;
+    bool inHandoff;
+
     KvmVM *const kvmVM;
 
     PhysicalMemory physmem;
@@ -677,6 +827,16 @@ class System : public MemObject
      * CPU switching happens.
      */
     const bool brg_fast_forward;
+
+    /**
+     * Where the workload is relative to its region of interest (ROI). In
+     * brg fast-forward mode only the first STATS_EN on/off pair switches
+     * CPUs (warmup -> main -> cooldown). Later toggles, or toggles from
+     * other harts, only reset and dump stats.
+     */
+    enum class BrgROIPhase { Before, Inside, After };
+    BrgROIPhase brg_roi_phase;
+
     const int num_nodes;
     const int num_cores;
 };
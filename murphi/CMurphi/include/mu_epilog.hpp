@@ -76,12 +76,16 @@
 #if defined(TRACE_DFS)
 #include "murphi.trace_dfs/mu_io.cpp"
 #else
+#if defined(PARALLEL_MURPHI)
+#include "murphi.parallel/mu_io.cpp"
+#else
 #include "murphi.original/mu_io.cpp"
 #endif
 #endif
 #endif
 #endif
 #endif
+#endif
 
 #include "murphi.original/mu_sym.cpp"
 
@@ -110,6 +114,10 @@
 #include "murphi.trace_dfs/mu_state.cpp"
 #include "murphi.trace_dfs/mu_system.cpp"
 #else
+#if defined(PARALLEL_MURPHI)
+#include "murphi.parallel/mu_state.cpp"
+#include "murphi.parallel/mu_system.cpp"
+#else
 #include "murphi.original/mu_state.cpp"
 #include "murphi.original/mu_system.cpp"
 #endif
@@ -117,6 +125,7 @@
 #endif
 #endif
 #endif
+#endif
 
 /****************************************
   real numbers extension
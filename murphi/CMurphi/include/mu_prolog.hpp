@@ -63,12 +63,17 @@
 //      suffix of trace info file
 #ifdef HASHC
 #define DEFAULT_BITS   40
+/* the parallel verifier stores signatures in whole words */
+#define PARALLEL_DEFAULT_BITS 64
 #define TRACE_FILE     ".trace"
 #endif
 
 /* Default Maximum number of error to search when -finderrors is used */
 #define DEFAULT_MAX_ERRORS 100
 
+/* Default bound on the length of the paths of a swarm search (-swarm) */
+#define DEFAULT_SWARM_DEPTH 1000
+
 /* the size of search queues as a percentage
    of the maximum number of states */
 
@@ -102,6 +107,11 @@
 /* gdp: length of split file segments */
 #define SPLITFILE_LEN (1024 * 0x100000L)
 
+/* the partial order reduction lives in the sequential verifier */
+#if defined(PARTIAL_ORDER) && defined(PARALLEL_MURPHI)
+#error "a model compiled with --por cannot use the parallel verifier"
+#endif
+
 /****************************************
   main headers
   ****************************************/
@@ -142,11 +152,15 @@
 #if defined(NO_HT)
 #include "murphi.noht/mu_io.hpp"
 #else
+#if defined(PARALLEL_MURPHI)
+#include "murphi.parallel/mu_io.hpp"
+#else
 #include "murphi.original/mu_io.hpp"
 #endif
 #endif
 #endif
 #endif
+#endif
 
 #if defined(DISK_MURPHI)
 #include "murphi.disk/mu_state.hpp"
@@ -173,6 +187,10 @@
 #include "murphi.trace_dfs/mu_state.hpp"
 #include "murphi.trace_dfs/mu_system.hpp"
 #else
+#if defined(PARALLEL_MURPHI)
+#include "murphi.parallel/mu_state.hpp"
+#include "murphi.parallel/mu_system.hpp"
+#else
 #include "murphi.original/mu_state.hpp"
 #include "murphi.original/mu_system.hpp"
 #endif
@@ -180,6 +198,7 @@
 #endif
 #endif
 #endif
+#endif
 
 /****************************************
   real numbers extension
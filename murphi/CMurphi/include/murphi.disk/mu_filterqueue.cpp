@@ -29,6 +29,9 @@
 ******************************************************************************/
 
 #include <math.h>
+#include <fcntl.h>		// for posix_fadvise()
+#include <errno.h>
+#include <sys/time.h>		// for gettimeofday()
 
 #define min(a,b) (((a)<(b))?(a):(b))
 #define max(a,b) (((a)>(b))?(a):(b))
@@ -100,6 +103,8 @@ state_filtering_queue::state_filtering_queue(unsigned long mas)
   if ((history_file = tmpfile()) == NULL) {
     Error.Notrace("Internal: Error creating history file.");
   }
+  // the history is scanned in order: let the kernel read far ahead
+  posix_fadvise(fileno(history_file), 0, 0, POSIX_FADV_SEQUENTIAL);
 #else
   paging_file_top = new splitFile(SPLITFILE_LEN, false);
   paging_file_bottom = new splitFile(SPLITFILE_LEN, false);
@@ -142,6 +147,10 @@ state_filtering_queue::state_filtering_queue(unsigned long mas)
   last_deleted_states = 0;
   hashtable_num_elts = 0;
   hashtable_first_full = false;
+
+  scan_buffer = new Unsigned32[2 * 2 * SCAN_CHUNK];
+  scanned_signatures = 0;
+  scan_seconds = 0;
 }
 
 
@@ -149,6 +158,7 @@ state_filtering_queue::~state_filtering_queue()
 {
   delete[]stateArray;
   delete[]filterTable;
+  delete[]scan_buffer;
   delete uncheckedQueue;
   delete Full;
   delete Removed;
@@ -194,6 +204,11 @@ int state_filtering_queue::BytesForOneState_hashtable(void)
   return (int) ceil((double) args->num_bits.value / 8.0);	//gdp: approx
 }
 
+int state_filtering_queue::BytesForOneState_history(void)
+{
+  return 2 * sizeof(Unsigned32);	/* one signature */
+}
+
 void state_filtering_queue::Print(void)
 {
   unsigned long i;
@@ -770,61 +785,103 @@ void state_filtering_queue::Calibrate(unsigned long deleted_a,
 
 }
 
+#ifndef SPLITFILE
+void state_filtering_queue::start_scan_read(int half, off_t offset,
+					    unsigned long signatures)
+{
+  struct aiocb *request = &scan_request[half];
+
+  memset(request, 0, sizeof(*request));
+  request->aio_fildes = fileno(history_file);
+  request->aio_offset = offset;
+  request->aio_buf = scan_buffer + half * 2 * SCAN_CHUNK;
+  request->aio_nbytes = sizeof(Unsigned32) * 2 * signatures;
+  if (aio_read(request) != 0)
+    Error.Notrace("Internal: Error reading history file.");
+}
+
+unsigned long state_filtering_queue::finish_scan_read(int half)
+{
+  const struct aiocb *request = &scan_request[half];
+  ssize_t bytes;
+
+  while (aio_error(request) == EINPROGRESS)
+    aio_suspend(&request, 1, NULL);
+  if ((bytes = aio_return(&scan_request[half])) < 0)
+    Error.Notrace("Internal: Error reading history file.");
+  return bytes / (sizeof(Unsigned32) * 2);
+}
+#endif
+
+unsigned long
+    state_filtering_queue::FilterChunk(const Unsigned32 * signatures,
+				       unsigned long count)
+{
+  unsigned long i, deleted = 0;
+
+#if (DBG > 10)
+  fprintf(stderr, "FilterTable(): buffer read: ");
+  for (i = 0; i < count * 2; i++)
+    fprintf(stderr, "%lu, ", signatures[i]);
+#endif
+
+  for (i = 0; i < count; i++)
+    if (hashtable_lookup(signatures[i * 2], signatures[i * 2 + 1],
+			 false, true))
+      deleted++;
+  return deleted;
+}
+
 unsigned long
     state_filtering_queue::FilterTable(unsigned long states,
 				       unsigned long *_totread)
 {
-#if __WORDSIZE == 32
-  unsigned long buffer[4000];	//read 2000 signatures at a time
-#else
-  unsigned int buffer[4000];	//read 2000 signatures at a time
-#endif
   unsigned long read, totread = 0, totdeleted = 0;
-  unsigned long i;
+  struct timeval begin, end;
+
+  gettimeofday(&begin, NULL);
 
 #if (DBG > 10)
   fprintf(stderr, "FilterTable(): Progress: ");
 #endif
 
-
 #ifndef SPLITFILE
-  while (!feof(history_file) && (totread < states)) {
-    read =
-#if __WORDSIZE == 32
-	fread(buffer, sizeof(unsigned long) * 2, min(2000, states),
-#else
-	fread(buffer, sizeof(unsigned int) * 2, min(2000, states),
-#endif
-	      history_file);
+  // double buffering: the next chunk is read into one half of scan_buffer
+  // while the other half is filtered. The reads bypass the stream, so
+  // flush the appended signatures first and leave the stream after the
+  // last signature read, where an adjacent block starts.
+  off_t offset = ftello(history_file);
+  unsigned long chunk = min(SCAN_CHUNK, states), next;
+  int half = 0;
+
+  fflush(history_file);
+  if (chunk > 0)
+    start_scan_read(half, offset, chunk);
+  while (chunk > 0) {
+    read = finish_scan_read(half);
+    totread += read;
+    offset += sizeof(Unsigned32) * 2 * read;
+    next = (read == chunk) ? min(SCAN_CHUNK, states - totread) : 0;
+    if (next > 0)
+      start_scan_read(1 - half, offset, next);
+    totdeleted += FilterChunk(scan_buffer + half * 2 * SCAN_CHUNK, read);
+    half = 1 - half;
+    chunk = next;
+  }
+  fseeko(history_file, offset, SEEK_SET);
 #else
   while (!history_file->eof() && (totread < states)) {
-    read =
-#if __WORDSIZE == 32
-	history_file->read(buffer, sizeof(unsigned long) * 2,
-#else
-	history_file->read(buffer, sizeof(unsigned int) * 2,
-#endif
-			   min(2000, states));
-#endif
+    read = history_file->read(scan_buffer, sizeof(Unsigned32) * 2,
+			      min(SCAN_CHUNK, states - totread));
     totread += read;
-
-#if (DBG > 10)
-    fprintf(stderr, "FilterTable(): buffer read: ");
-    for (i = 0; i < read * 2; i++)
-      fprintf(stderr, "%lu, ", buffer[i]);
-#endif
-
-    for (i = 0; i < read; i++) {
-      if (hashtable_lookup(buffer[i * 2], buffer[i * 2 + 1], false, true))
-	totdeleted++;
-
-#if (DBG > 10)
-      fprintf(stderr, "#%lu", totread - read + i);
+    totdeleted += FilterChunk(scan_buffer, read);
+  }
 #endif
 
-
-    }
-  }
+  gettimeofday(&end, NULL);
+  scanned_signatures += totread;
+  scan_seconds += (end.tv_sec - begin.tv_sec) +
+      (end.tv_usec - begin.tv_usec) / 1e6;
 
 #if (DBG > 0)
   fprintf(stderr,
@@ -837,6 +894,21 @@ unsigned long
   return totdeleted;
 }
 
+void state_filtering_queue::write_history(state_and_signature_pair * s)
+{
+#if (DBG > 10)
+  fprintf(stderr, "write_history(): buffer written: %lu,%lu ",
+	  s->_signature[0], s->_signature[1]);
+#endif
+
+#ifndef SPLITFILE
+  fwrite(s->_signature, sizeof(s->_signature), 1, history_file);
+#else
+  history_file->write(s->_signature, sizeof(s->_signature), 1);
+#endif
+  history_len++;
+}
+
 void
  state_filtering_queue::CheckTable()
 {
@@ -981,31 +1053,7 @@ void state_filtering_queue::CheckTable_full()
     if (hashtable_lookup(s->_signature[0], s->_signature[1], false, true)) {
       enqueue_checked(&(s->_state));
       moved++;			//for dbg only
-
-#if (DBG > 10)
-      fprintf(stderr, "CheckTable_full(): buffer written: %lu,%lu ",
-	      s->_signature[0], s->_signature[1]);
-#endif
-
-#ifndef SPLITFILE
-#if __WORDSIZE == 32		//Here and in related places, Unsigned32 should be used...
-      fwrite(&(s->_signature[0]), sizeof(unsigned long), 1, history_file);
-      fwrite(&(s->_signature[1]), sizeof(unsigned long), 1, history_file);
-#else
-      fwrite(&(s->_signature[0]), sizeof(unsigned int), 1, history_file);
-      fwrite(&(s->_signature[1]), sizeof(unsigned int), 1, history_file);
-#endif
-#else
-#if __WORDSIZE == 32
-      history_file->write(&(s->_signature[0]), sizeof(unsigned long), 1);
-      history_file->write(&(s->_signature[1]), sizeof(unsigned long), 1);
-#else
-      history_file->write(&(s->_signature[0]), sizeof(unsigned int), 1);
-      history_file->write(&(s->_signature[1]), sizeof(unsigned int), 1);
-#endif
-#endif
-      history_len++;
-
+      write_history(s);
     } else {
       deleted++;
     }
@@ -1062,30 +1110,7 @@ void state_filtering_queue::CheckTable_simple()
     s = uncheckedQueue->dequeue();
     enqueue_checked(&(s->_state));
     moved++;			//for dbg only
-
-#if (DBG > 10)
-    fprintf(stderr, "CheckTable_simple(): buffer written: %lu,%lu ",
-	    s->_signature[0], s->_signature[1]);
-#endif
-
-#ifndef SPLITFILE
-#if __WORDSIZE == 32
-    fwrite(&(s->_signature[0]), sizeof(unsigned long), 1, history_file);
-    fwrite(&(s->_signature[1]), sizeof(unsigned long), 1, history_file);
-#else
-    fwrite(&(s->_signature[0]), sizeof(unsigned int), 1, history_file);
-    fwrite(&(s->_signature[1]), sizeof(unsigned int), 1, history_file);
-#endif
-#else
-#if __WORDSIZE == 32
-    history_file->write(&(s->_signature[0]), sizeof(unsigned long), 1);
-    history_file->write(&(s->_signature[1]), sizeof(unsigned long), 1);
-#else
-    history_file->write(&(s->_signature[0]), sizeof(unsigned int), 1);
-    history_file->write(&(s->_signature[1]), sizeof(unsigned int), 1);
-#endif
-#endif
-    history_len++;
+    write_history(s);
   }
 
 #if (DBG > 0)
@@ -1103,43 +1128,16 @@ state_filtering_queue::signature_hash(unsigned int t1, unsigned int t2)
 #endif
 {
 
-  unsigned long i, total, base;
+  // the signature bits come from h3 and are uniform already: a
+  // multiplicative mix is enough, and it is called once for every
+  // signature read from the history file
 #if __WORDSIZE == 32
-  char data[sizeof(unsigned long) * 2];
-
-  memcpy(&(data[0]), &t1, sizeof(unsigned long));
-  memcpy(&(data[sizeof(unsigned long)]), &t2, sizeof(unsigned long));
+  unsigned long h = (t1 ^ t2 * 0x9e3779b1UL) * 0x85ebca6bUL;
+  return h ^ (h >> 13);
 #else
-  char data[sizeof(unsigned int) * 2];
-
-  memcpy(&(data[0]), &t1, sizeof(unsigned int));
-  memcpy(&(data[sizeof(unsigned int)]), &t2, sizeof(unsigned int));
+  unsigned long h = ((unsigned long) t1 << 32 | t2) * 0x9e3779b97f4a7c15UL;
+  return h ^ (h >> 29);
 #endif
-
-#if (DBG > 10)
-  fprintf(stderr,
-	  "signature_hash: creating hashkey from t1=%lu and t2=%lu\n", t1,
-	  t2);
-#endif
-
-  base = 1u;
-  total = data[0] % (hashtable_size);
-
-#if __WORDSIZE == 32
-  for (i = 1; i < (sizeof(unsigned long) * 2); i++) {
-#else
-  for (i = 1; i < (sizeof(unsigned int) * 2); i++) {
-#endif
-    base =
-	(((UINT_MAX % hashtable_size +
-	   1) % hashtable_size) * base) % hashtable_size;
-    total =
-	(total +
-	 (base * (data[i] % hashtable_size)) % hashtable_size) %
-	hashtable_size;
-  }
-
-  return (total);
 }
 
 //*****************************************************************************
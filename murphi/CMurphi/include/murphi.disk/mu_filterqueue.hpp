@@ -31,6 +31,8 @@
 #ifndef _FILTERQUEUE_
 #define _FILTERQUEUE_
 
+#include <aio.h>		/* for the double-buffered history scan */
+
 #define NEUTRAL_ZONE_HI_BOUND 0.5
 #define NEUTRAL_ZONE_LO_BOUND 0.3
 
@@ -52,6 +54,10 @@
 
 #define AGING 2.0
 
+/* signatures read from the history file at a time; the scan reads one
+   chunk while it filters the previous one */
+#define SCAN_CHUNK (1 << 16)
+
 /***********************************************
   Pair containing a state and its hash signature.
   Used by the unchecked queue.
@@ -207,6 +213,17 @@ protected:
   unsigned long hashtable_size;
   unsigned long hashtable_num_elts;
 
+  Unsigned32 *scan_buffer;	/* two halves of SCAN_CHUNK signatures */
+#ifndef SPLITFILE
+  struct aiocb scan_request[2];	/* pending read into each half */
+  void start_scan_read(int half, off_t offset, unsigned long signatures);
+  unsigned long finish_scan_read(int half);
+#endif
+  unsigned long scanned_signatures;	/* read from the history file */
+  double scan_seconds;		/* spent reading and filtering them */
+
+  void write_history(state_and_signature_pair * s);
+
   bool enqueue_checked(state * e);
   state *dequeue_checked(void);
   state *top_checked(void);
@@ -219,6 +236,8 @@ protected:
   void Calibrate(unsigned long deleted_a, unsigned long deleted_b);
   unsigned long FilterTable(unsigned long states, unsigned long *_totread =
 			    NULL);
+  unsigned long FilterChunk(const Unsigned32 * signatures,
+			    unsigned long count);
 
   double SelectionP(unsigned long block);
 
@@ -252,6 +271,12 @@ public:
   double DiskAlpha(void) {
     return filter_alpha;
   }
+  unsigned long ScannedSignatures(void) {
+    return scanned_signatures;
+  }
+  double ScanSeconds(void) {
+    return scan_seconds;
+  }
   inline bool isempty(void);
 
   //to avoid problems with table lookup, declare it full a bit before it is really full
@@ -269,6 +294,7 @@ public:
   inline static int BytesForOneState_checked(void);
   inline static int BytesForOneState_unchecked(void);
   inline static int BytesForOneState_hashtable(void);
+  inline static int BytesForOneState_history(void);
 
   // storing and removing elements
   virtual bool enqueue(state * &e) {
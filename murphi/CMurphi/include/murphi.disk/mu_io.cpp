@@ -1214,7 +1214,9 @@ void ReportManager::print_summary(bool prob)
       << SecondsSinceStart() << "s.\n"
       << "\tClock time elapsed (includes disk accesses): " << elapsed_time
       << "s.\n" << "\tLevels Explored: " << StateSet->CurrentLevel() -
-      1 << "\n\n";
+      1 << "\n";
+  StateSet->print_disk_usage();
+  cout << "\n";
 
 
   if (prob) {
@@ -240,6 +240,21 @@ void StateManager::print_capacity()
   }
 }
 
+void StateManager::print_disk_usage()
+{
+  // the history keeps a signature of every state that was queued
+  double bytes = (double) queue->ScannedSignatures() *
+      state_filtering_queue::BytesForOneState_history();
+
+  cout << "\tHistory on disk: " << queue->HistoryLength()
+      << " signatures of " << state_filtering_queue::
+      BytesForOneState_history() << " bytes each.\n";
+  if (bytes > 0)
+    cout << "\tHistory scanned: " << bytes / 1000000 << " Mbytes at "
+	<< bytes / 1000000 / max(queue->ScanSeconds(), 0.001)
+	<< " Mbytes/s.\n";
+}
+
 void StateManager::print_all_states()
 {
   //the_states->print();
@@ -64,6 +64,7 @@ public:
   void PrintProb();
 
   void print_capacity();
+  void print_disk_usage();
   void print_all_states();
   void print_trace(StatePtr p);	// changes by Uli
   void print_trace_aux(StatePtr p);
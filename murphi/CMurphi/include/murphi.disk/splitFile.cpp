@@ -286,18 +286,10 @@ unsigned long splitFile::writebytes(void *buffer, unsigned long size)
 unsigned long
     splitFile::write(void *buffer, unsigned long size, unsigned long count)
 {
-  unsigned long totalwritten = 0;
-  unsigned long pp = 0;
-
   _eof = false;
 
-  while (count > totalwritten) {
-    writebytes(((char *) buffer) + pp, size);
-    pp += size;
-    totalwritten++;
-  }
-
-  return totalwritten;
+  // the whole block at once: writebytes() crosses the parts itself
+  return writebytes(buffer, size * count) / size;
 }
 
 unsigned long
@@ -332,18 +324,8 @@ unsigned long
 unsigned long
     splitFile::read(void *buffer, unsigned long size, unsigned long count)
 {
-  unsigned long read, totalread = 0;
-  unsigned long pp = 0;
-
-  while (count > totalread) {
-    read = readbytes(((char *) buffer) + pp, size);
-    pp += read;
-    if (read != size)
-      break;			//eof
-    totalread++;
-  }
-
-  return totalread;
+  // the whole block at once; only complete elements count, as in fread
+  return readbytes(buffer, size * count) / size;
 }
 
 /*
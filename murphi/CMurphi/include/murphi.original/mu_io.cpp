@@ -966,6 +966,19 @@ void
       break;
     }
   }
+
+#ifdef PARTIAL_ORDER
+  if (args->main_alg.mode == argmain_alg::Verify_bfs) {
+    if (PO->Enabled() && PO->Independent() == 0)
+      cout << "\twith partial order reduction, but no two rules are "
+	  << "independent: nothing will be reduced.\n";
+    else if (PO->Enabled())
+      cout << "\twith partial order reduction.\n";
+    else
+      cout << "\tPartial order reduction disabled: "
+	  << "the rules have different priorities.\n";
+  }
+#endif
 }
 
 // added by Uli
@@ -1107,6 +1120,11 @@ void ReportManager::print_summary(bool prob)
       << Rules->NumRulesFired() << " rules fired in "
       << SecondsSinceStart() << "s.\n\n";
 
+#ifdef PARTIAL_ORDER
+  if (PO->Enabled() && args->main_alg.mode == argmain_alg::Verify_bfs)
+    PO->print_summary();
+#endif
+
   if (prob) {
 #ifdef HASHC
     // Uli: print omission probabilities
@@ -167,6 +167,62 @@ public:
   };
 #endif
 
+  // compare and exchange two packed values of the same size, such as
+  // two elements of a multiset in the state vector.  The order is the
+  // one of the encoded values, which is all multiset reduction needs.
+#ifndef ALIGN
+  inline unsigned int getbits(int os, int size) const {
+    const unsigned int *l = (const unsigned int *) bits + os / 32;
+    unsigned long long val = l[0];
+    if (os % 32 + size > 32)
+      val |= (unsigned long long) l[1] << 32;
+    val >>= os % 32;
+    return size < 32 ? (unsigned int) val & ((1U << size) - 1) :
+	(unsigned int) val;
+  }
+  inline void setbits(int os, int size, unsigned int value) {
+    unsigned int *l = (unsigned int *) bits + os / 32;
+    unsigned long long mask =
+	(size < 32 ? (1ULL << size) - 1 : 0xffffffffULL) << (os % 32);
+    unsigned long long val = ((unsigned long long) value << (os % 32)) & mask;
+    l[0] = (l[0] & ~(unsigned int) mask) | (unsigned int) val;
+    if (mask >> 32)
+      l[1] = (l[1] & ~(unsigned int) (mask >> 32)) | (unsigned int) (val >> 32);
+  }
+  inline int cmpbits(int os1, int os2, int size) const {
+    unsigned int a, b;
+    for (int n; size > 0; os1 += n, os2 += n, size -= n) {
+      n = size < 32 ? size : 32;
+      a = getbits(os1, n);
+      b = getbits(os2, n);
+      if (a != b)
+	return a < b ? -1 : 1;
+    }
+    return 0;
+  }
+  inline void swapbits(int os1, int os2, int size) {
+    unsigned int a;
+    for (int n; size > 0; os1 += n, os2 += n, size -= n) {
+      n = size < 32 ? size : 32;
+      a = getbits(os1, n);
+      setbits(os1, n, getbits(os2, n));
+      setbits(os2, n, a);
+    }
+  }
+#else
+  inline int cmpbits(int os1, int os2, int size) const {
+    return memcmp(bits + os1 / 8, bits + os2 / 8, size / 8);
+  }
+  inline void swapbits(int os1, int os2, int size) {
+    BIT_BLOCK t, *p = bits + os1 / 8, *q = bits + os2 / 8;
+    for (int i = size / 8; i > 0; i--) {
+      t = *p;
+      *p++ = *q;
+      *q++ = t;
+    }
+  }
+#endif
+
   // key for hash function, changes by Uli
 /* defines log_2(sizeof(long)) */
 #if __WORDSIZE == 32
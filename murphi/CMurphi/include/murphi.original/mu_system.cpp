@@ -463,6 +463,27 @@ bool RuleManager::AllNextStates()
   // get set of rules to fire
   fire = EnabledTransition();
 
+#ifdef PARTIAL_ORDER
+  // fire an ample subset, and the other rules only if it may close a cycle
+  if (PO->Enabled() && args->main_alg.mode == argmain_alg::Verify_bfs) {
+    setofrules *ample = PO->AmpleSet(fire);
+    if (ample != fire) {
+      static setofrules rest;
+      bool deadlocked = AllNextStates(ample);
+
+      if (!revisited) {
+	PO->CountReduced();
+	return deadlocked;
+      }
+      rest.removeall();
+      for (int r = 0; r < numrules; r++)
+	if (fire->in(r) && !ample->in(r))
+	  rest.add(r);
+      return AllNextStates(&rest) && deadlocked;
+    }
+  }
+#endif
+
   // generate the set of next states
   return AllNextStates(fire);
 }
@@ -524,6 +545,7 @@ bool RuleManager::AllNextStates(setofrules * fire)
   bool permanent;
 
   StateCopy(originalstate, workingstate);	// make copy of workingstate
+  revisited = FALSE;
 
   /*
      for ( what_rule=0; what_rule<numrules; what_rule++)
@@ -552,9 +574,11 @@ bool RuleManager::AllNextStates(setofrules * fire)
       if (StateCmp(curstate, nextstate) != 0) {
 	deadlocked_so_far = FALSE;
 	permanent = (generator->Priority(what_rule) < 50);	// Uli
-	(void) StateSet->Add(nextstate, TRUE, permanent);
+	if (!StateSet->Add(nextstate, TRUE, permanent))
+	  revisited = TRUE;
 	StateCopy(workingstate, originalstate);	// restore workingstate
-      }
+      } else
+	revisited = TRUE;
     }
   }
   return deadlocked_so_far;
@@ -706,8 +730,208 @@ SymmetryManager::SymmetryManager()
 /************************************************************/
 POManager::POManager()
 {
+#ifdef PARTIAL_ORDER
+  NextStateGenerator *generator = new NextStateGenerator;
+
+  // the minimum priority filter would interfere with the ample sets
+  enabled = TRUE;
+  reduced = 0;
+  independent = 0;
+  for (int r = 1; r < RULES_IN_WORLD; r++)
+    if (generator->Priority(r) != generator->Priority(0))
+      enabled = FALSE;
+  if (enabled)
+    build(generator);
+  delete generator;
+#endif
 }
 
+#ifdef PARTIAL_ORDER
+struct po_entry {
+  unsigned rule;
+  int index;
+  footprint::access_kind kind;
+};
+
+static bool po_overlap(int i, int j)
+{
+  return i == j || i == FOOTPRINT_ANY || j == FOOTPRINT_ANY;
+}
+
+static bool po_reads(footprint::access_kind k)
+{
+  return k == footprint::Guard || k == footprint::Read;
+}
+
+static bool po_writes(footprint::access_kind k)
+{
+  return k == footprint::Write || k == footprint::Add;
+}
+
+/* Two rules conflict if they access the same location and not both
+   only read it or only add to it (multisets are kept sorted, so the
+   order of two additions does not matter).  A rule may enable t if
+   it writes a location read by the condition of t. */
+void POManager::build(NextStateGenerator * generator)
+{
+  footprint *fp = new footprint[RULES_IN_WORLD];
+  footprint inv;
+  int numvars = 0;
+  int r, c, i, j, v;
+
+  for (r = 0; r < RULES_IN_WORLD; r++) {
+    generator->Footprint(r, fp[r]);
+    for (i = 0; i < fp[r].size(); i++)
+      if (fp[r][i].var >= numvars)
+	numvars = fp[r][i].var + 1;
+  }
+  generator->InvariantFootprint(inv);
+
+  conflict_matrix = new rule_matrix;
+  enable_matrix = new rule_matrix;
+  visible = new setofrules;
+  ample = new setofrules;
+  work = new unsigned[RULES_IN_WORLD];
+  best = new unsigned[RULES_IN_WORLD];
+
+  // bucket the accesses by variable
+  int *start = new int[numvars + 1];
+  for (v = 0; v <= numvars; v++)
+    start[v] = 0;
+  for (r = 0; r < RULES_IN_WORLD; r++)
+    for (i = 0; i < fp[r].size(); i++)
+      start[fp[r][i].var + 1]++;
+  for (v = 0; v < numvars; v++)
+    start[v + 1] += start[v];
+  po_entry *bucket = new po_entry[start[numvars] + 1];
+  int *fill = new int[numvars];
+  for (v = 0; v < numvars; v++)
+    fill[v] = start[v];
+  for (r = 0; r < RULES_IN_WORLD; r++)
+    for (i = 0; i < fp[r].size(); i++) {
+      po_entry & e = bucket[fill[fp[r][i].var]++];
+      e.rule = r;
+      e.index = fp[r][i].index;
+      e.kind = fp[r][i].kind;
+    }
+
+  for (v = 0; v < numvars; v++)
+    for (i = start[v]; i < start[v + 1]; i++)
+      for (j = i + 1; j < start[v + 1]; j++) {
+	po_entry & a = bucket[i];
+	po_entry & b = bucket[j];
+	if (a.rule == b.rule || !po_overlap(a.index, b.index))
+	  continue;
+	if (!(po_reads(a.kind) && po_reads(b.kind)) &&
+	    !(a.kind == footprint::Add && b.kind == footprint::Add)) {
+	  conflict_matrix->set(a.rule, b.rule);
+	  conflict_matrix->set(b.rule, a.rule);
+	}
+	if (po_writes(a.kind) && b.kind == footprint::Guard)
+	  enable_matrix->set(b.rule, a.rule);
+	if (po_writes(b.kind) && a.kind == footprint::Guard)
+	  enable_matrix->set(a.rule, b.rule);
+      }
+
+  // rules changing a variable of an invariant
+  for (i = 0; i < inv.size(); i++)
+    if (inv[i].var < numvars)
+      for (j = start[inv[i].var]; j < start[inv[i].var + 1]; j++)
+	if (po_writes(bucket[j].kind)
+	    && po_overlap(bucket[j].index, inv[i].index))
+	  visible->add(bucket[j].rule);
+
+  // rules the compiler could not analyse depend on everything
+  for (r = 0; r < RULES_IN_WORLD; r++)
+    if (fp[r].isall() || inv.isall()) {
+      if (inv.isall())
+	visible->add(r);
+      if (!fp[r].isall())
+	continue;
+      visible->add(r);
+      conflict_matrix->setrow(r);
+      enable_matrix->setrow(r);
+      for (c = 0; c < RULES_IN_WORLD; c++) {
+	conflict_matrix->set(c, r);
+	enable_matrix->set(c, r);
+      }
+    }
+
+  // without such a pair no ample set is ever smaller than the enabled set
+  for (r = 0; r < RULES_IN_WORLD; r++)
+    if (!visible->in(r))
+      for (c = r + 1; c < RULES_IN_WORLD; c++)
+	if (!visible->in(c) && !conflict_matrix->in(r, c))
+	  independent++;
+
+  delete[]fill;
+  delete[]bucket;
+  delete[]start;
+  delete[]fp;
+}
+
+/* Closes {seed} under the conflicts of its enabled rules and the
+   enabling rules of its disabled ones.  Returns the number of enabled
+   rules in the closure, or -1 if it contains a visible rule or at
+   least limit enabled rules; otherwise they are left in best. */
+int POManager::closure(unsigned seed, setofrules * fire, int limit)
+{
+  static setofrules s;
+  int n = 1, head = 0, nenabled = 0;
+  bool ok = TRUE;
+
+  s.add(seed);
+  work[0] = seed;
+  while (head < n) {
+    unsigned t = work[head++];
+    if (fire->in(t)) {
+      if (visible->in(t) || ++nenabled >= limit) {
+	ok = FALSE;
+	break;
+      }
+      n += conflict_matrix->include_row(t, s, work + n);
+    } else
+      n += enable_matrix->include_row(t, s, work + n);
+  }
+
+  nenabled = 0;
+  for (int i = 0; i < n; i++) {
+    if (ok && fire->in(work[i]))
+      best[nenabled++] = work[i];
+    s.remove(work[i]);
+  }
+  return ok ? nenabled : -1;
+}
+
+setofrules *POManager::AmpleSet(setofrules * fire)
+{
+  int size = fire->size();
+  int nbest = size;
+  int n;
+
+  if (size <= 1)
+    return fire;
+
+  // the smallest closure over the enabled rules
+  for (int r = 0; r < RULES_IN_WORLD && nbest > 1; r++)
+    if (fire->in(r) && (n = closure(r, fire, nbest)) >= 0)
+      nbest = n;
+  if (nbest == size)
+    return fire;
+
+  ample->removeall();
+  for (int i = 0; i < nbest; i++)
+    ample->add(best[i]);
+  return ample;
+}
+
+void POManager::print_summary()
+{
+  cout << "\t" << reduced
+      << " states expanded with a partial order reduced set of rules.\n\n";
+}
+#endif
+
 /************************************************************/
 /* AlgorithmManager */
 /************************************************************/
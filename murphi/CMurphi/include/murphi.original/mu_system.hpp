@@ -104,6 +104,7 @@ class RuleManager {
 
   setofrules *EnabledTransition();
   bool AllNextStates(setofrules * fire);
+  bool revisited;		// a next state was already in the state set
   state *NextState();
   randomGen random;		// Uli: random number generator
 
@@ -147,8 +148,34 @@ public:
 class POManager			// Partial Order
 {
   rule_matrix *conflict_matrix;
+#ifdef PARTIAL_ORDER
+  rule_matrix *enable_matrix;	/* rules whose firing may enable a rule */
+  setofrules *visible;		/* rules that may change an invariant */
+  setofrules *ample;
+  unsigned *work;		/* closure worklist */
+  unsigned *best;		/* smallest ample set found so far */
+  bool enabled;
+  unsigned long reduced;	/* states expanded with a proper ample set */
+  unsigned long independent;	/* pairs of invisible, independent rules */
+
+  void build(NextStateGenerator * generator);
+  int closure(unsigned seed, setofrules * fire, int limit);
+#endif
 public:
    POManager();
+#ifdef PARTIAL_ORDER
+  bool Enabled() {
+    return enabled;
+  };
+  setofrules *AmpleSet(setofrules * fire);
+  void CountReduced() {
+    reduced++;
+  };
+  unsigned long Independent() {
+    return independent;
+  };
+  void print_summary();
+#endif
 };
 
 /************************************************************/
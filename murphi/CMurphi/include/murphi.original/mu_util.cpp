@@ -407,6 +407,12 @@ randomGen::randomGen()
     value = 46831694;
 }
 
+void randomGen::seed(unsigned long s)
+{
+  // the generator needs 0 < value < 2^31-1
+  value = s % 2147483646 + 1;
+}
+
 unsigned long
  randomGen::next()
 {
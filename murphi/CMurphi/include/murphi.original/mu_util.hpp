@@ -51,6 +51,7 @@
   3) world_class
   4) timer (not in any class)
   5) random number generator
+  6) footprint (partial order reduction)
  ****************************************/
 
 /****************************************
@@ -749,5 +750,77 @@ private:
   unsigned long value;
 public:
    randomGen();
+  void seed(unsigned long s);	// restart a reproducible sequence
   unsigned long next();		// return next random number
 };
+
+/***************************
+  footprint of a rule
+  -- the global variables a rule instance may read or write, as
+  -- found by the compiler; variables are numbered in declaration
+  -- order, the index is the first array index (if known)
+ ***************************/
+#define FOOTPRINT_ANY INT_MIN	/* index not known statically */
+
+class footprint {
+public:
+  enum access_kind { Guard, Read, Write, Add };
+  struct access {
+    int var;
+    int index;
+    access_kind kind;
+  };
+
+private:
+  access *accesses;
+  int num, max;
+  bool universal;		/* may touch any variable */
+
+  void push(int var, int index, access_kind kind) {
+    if (num == max) {
+      access *a = new access[max = max ? 2 * max : 8];
+      for (int i = 0; i < num; i++)
+	a[i] = accesses[i];
+      delete[]accesses;
+      accesses = a;
+    }
+    accesses[num].var = var;
+    accesses[num].index = index;
+    accesses[num].kind = kind;
+    num++;
+  };
+
+public:
+  footprint():accesses(NULL), num(0), max(0), universal(FALSE) {
+  };
+  ~footprint() {
+    delete[]accesses;
+  };
+
+  // filled in by the generated code
+  void guard(int var, int index) {
+    push(var, index, Guard);
+  };
+  void read(int var, int index) {
+    push(var, index, Read);
+  };
+  void write(int var, int index) {
+    push(var, index, Write);
+  };
+  void add(int var, int index) {
+    push(var, index, Add);
+  };
+  void all() {
+    universal = TRUE;
+  };
+
+  bool isall() const {
+    return universal;
+  };
+  int size() const {
+    return num;
+  };
+  const access & operator[] (int i) const {
+    return accesses[i];
+  };
+};
@@ -75,6 +75,7 @@ public:
 
   // conflict set manipulation
   friend setofrules conflict(unsigned rule);
+  friend class rule_matrix;
 
   setofrules()
 :    NumRules(0) {
@@ -142,3 +143,57 @@ public:
       }
   };
 };
+
+/****************************************
+  class rule_matrix
+  require RULES_IN_WORLD
+  -- a square bit matrix over the rules, one setofrules per row
+  ****************************************/
+
+class rule_matrix {
+  BIT_BLOCK *bits;
+
+  BIT_BLOCK *row(int r) const {
+    return bits + (unsigned long) r * BLOCKS_IN_SETOFRULES;
+  };
+
+public:
+  rule_matrix() {
+    unsigned long n = (unsigned long) RULES_IN_WORLD * BLOCKS_IN_SETOFRULES;
+    bits = new BIT_BLOCK[n];
+    for (unsigned long i = 0; i < n; i++)
+      bits[i] = 0;
+  };
+  ~rule_matrix() {
+    delete[]bits;
+  };
+
+  bool in(int r, int c) const {
+    return (bool) ((row(r)[c / BITS(BIT_BLOCK)] >> (c % BITS(BIT_BLOCK)))
+		   & 1);
+  };
+  void set(int r, int c) {
+    row(r)[c / BITS(BIT_BLOCK)] |= (1 << (c % BITS(BIT_BLOCK)));
+  };
+  void setrow(int r) {
+    for (int c = 0; c < RULES_IN_WORLD; c++)
+      set(r, c);
+  };
+
+  // add row r to rs; the rules not already in rs are stored in added
+  int include_row(int r, setofrules & rs, unsigned *added) const {
+    BIT_BLOCK *b = row(r);
+    int n = 0;
+    for (int i = 0; i < BLOCKS_IN_SETOFRULES; i++) {
+      BIT_BLOCK fresh = b[i] & ~rs.bits[i];
+      if (fresh != 0) {
+	rs.bits[i] |= fresh;
+	for (int k = 0; k < BITS(BIT_BLOCK); k++)
+	  if ((fresh >> k) & 1)
+	    added[n++] = i * BITS(BIT_BLOCK) + k;
+      }
+    }
+    rs.NumRules += n;
+    return n;
+  };
+};
@@ -166,6 +166,10 @@ int main(int argc, char **argv)
     Algorithm->verify_dfs();
   } else if (args->main_alg.mode == argmain_alg::Simulate) {
     Algorithm->simulate();
+#ifdef PARALLEL_MURPHI
+  } else if (args->main_alg.mode == argmain_alg::Swarm) {
+    Algorithm->swarm();
+#endif
   }
 
   cout.flush();
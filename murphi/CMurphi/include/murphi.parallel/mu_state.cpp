@@ -0,0 +1,768 @@
+/**CFile***********************************************************************
+
+  FileName    [mu_state.cpp]
+
+  Synopsis    [File for queue and hash table]
+
+  Author      [Igor Melatti]
+
+  Copyright   [
+  This file is part of the parallel verifier package of CMurphi. 
+  Copyright (C) 2009-2012 by Sapienza University of Rome. 
+
+  CMurphi is free software; you can redistribute it and/or 
+  modify it under the terms of the GNU Lesser General Public 
+  License as published by the Free Software Foundation; either 
+  of the License, or (at your option) any later version.
+
+  CMurphi is distributed in the hope that it will be useful, 
+  but WITHOUT ANY WARRANTY; without even the implied warranty of 
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU 
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public 
+  License along with this library; if not, write to the Free Software 
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA.
+
+  To contact the CMurphi development board, email to <melatti@di.uniroma1.it>. ]
+
+******************************************************************************/
+
+#include <sys/mman.h>
+#include <sched.h>
+
+/****************************************
+  There are 6 groups of implementations:
+  1) shared memory
+  2) class StatePtr and state related stuff
+  3) state queue and stack
+  4) state set
+  5) parallel frontier
+  6) swarm search: bitstate filter and path
+  ****************************************/
+
+void
+ state::print()
+{
+  theworld.print();
+};
+
+/****************************************
+  Shared memory.
+  ****************************************/
+void *shared_alloc(unsigned long bytes)
+{
+  // zero-filled and only backed by memory once touched
+  void *p = mmap(NULL, bytes, PROT_READ | PROT_WRITE,
+		 MAP_SHARED | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (p == MAP_FAILED)
+    Error.Notrace("Cannot map %lu bytes of shared memory.", bytes);
+  return p;
+}
+
+void shared_free(void *p, unsigned long bytes)
+{
+  munmap(p, bytes);
+}
+
+
+/****************************************
+  class StatePtr and state related stuff.
+  ****************************************/
+
+inline void
+ StatePtr::sCheck()
+{
+#ifdef HASHC
+  if (args->trace_file.value)
+    Error.Notrace("Internal: Illegal Access to StatePtr.");
+#endif
+}
+
+inline void StatePtr::lCheck()
+{
+#ifdef HASHC
+  if (!args->trace_file.value)
+    Error.Notrace("Internal: Illegal Access to StatePtr.");
+#endif
+}
+
+StatePtr::StatePtr(state * s)
+{
+  sCheck();
+  sp = s;
+}
+
+StatePtr::StatePtr(unsigned long l)
+{
+  lCheck();
+  lv = l;
+}
+
+void
+ StatePtr::set(state * s)
+{
+  sCheck();
+  sp = s;
+}
+
+void StatePtr::set(unsigned long l)
+{
+  lCheck();
+  lv = l;
+}
+
+void StatePtr::clear()
+{
+#ifdef HASHC
+  if (args->trace_file.value)
+    lv = 0;
+  else
+#endif
+    sp = NULL;
+}
+
+state *StatePtr::sVal()
+{
+  sCheck();
+  return sp;
+}
+
+unsigned long StatePtr::lVal()
+{
+  lCheck();
+  return lv;
+}
+
+StatePtr StatePtr::previous()
+{				// return StatePtr to previous state
+#ifdef HASHC
+  if (args->trace_file.value)
+    return TraceFile->read(lv)->previous;
+  else
+#endif
+    return sp->previous.sp;
+}
+
+bool StatePtr::isStart()
+{				// check if I point to a startstate
+#ifdef HASHC
+  if (args->trace_file.value) {
+    if (TraceFile->read(lv)->previous == 0)
+      return TRUE;
+    return FALSE;
+  } else
+#endif
+  {
+    if (sp->previous.sp == NULL)
+      return TRUE;
+    return FALSE;
+  }
+}
+
+#define BITUNSIGNED 32		//sizeof(Unsigned32)*CHAR_BIT
+
+bool StatePtr::compare(state * s)
+{				// compare the state I point to with s
+#ifdef HASHC
+  if (args->trace_file.value) {
+#if __WORDSIZE == 32
+    unsigned long *
+#else
+    unsigned int *
+#endif
+	key = h3->hash(s, FALSE);
+#if __WORDSIZE == 32
+    unsigned long
+#else
+    unsigned int
+#endif
+	c1 = key[1] &
+#if __WORDSIZE == 32
+	((~0UL) <<
+	 (args->num_bits.value >
+	  BITUNSIGNED ? 0UL : BITUNSIGNED - args->num_bits.value));
+#else
+	((~0) <<
+	 (args->num_bits.value >
+	  BITUNSIGNED ? 0 : BITUNSIGNED - args->num_bits.value));
+#endif
+#if __WORDSIZE == 32
+    unsigned long
+#else
+    unsigned int
+#endif
+	c2 = key[2] & (args->num_bits.value >
+#if __WORDSIZE == 32
+		       BITUNSIGNED ? (~0UL) << (2 * BITUNSIGNED -
+						args->num_bits.
+						value) : 0UL);
+#else
+		       BITUNSIGNED ? (~0) << (2 * BITUNSIGNED -
+					      args->num_bits.value) : 0);
+#endif
+
+    return (c1 == TraceFile->read(lv)->c1 &&
+	    c2 == TraceFile->read(lv)->c2);
+  } else
+#endif
+    return (StateCmp(sp, s) == 0);
+}
+
+
+void StateCopy(state * l, state * r)
+// Uli: uses default assignment operator
+{
+  *l = *r;
+}
+
+int StateCmp(state * l, state * r)
+{
+  int i = BLOCKS_IN_WORLD / 4;
+  register int *d = (int *) l->bits, *s = (int *) r->bits;
+
+  while (i--)
+    if (*d > *s)
+      return 1;
+    else if (*d++ < *s++)
+      return -1;
+  return 0;
+}
+
+void copy_state(state * &s)
+{
+  state *h;
+
+  if ((h = new state) == NULL)
+    Error.Notrace
+	("New failed. Swap space probably too small for state queue.");
+  *h = *s;
+  s = h;
+}
+
+bool StateEquivalent(state * l, StatePtr r)
+{
+  return match(l, r);
+}
+
+/****************************************
+  class state_queue for searching the state space.
+  ****************************************/
+state_queue::state_queue(unsigned long mas)
+:  max_active_states(mas), num_elts(0), front(0), rear(0)
+{
+  stateArray = new state *[max_active_states];
+
+  for (long i = 0; i < max_active_states; i++)	// Uli: avoid bzero
+    stateArray[i] = NULL;
+};
+
+state_queue::~state_queue()
+{
+  delete[OLD_GPP(max_active_states)] stateArray;	// Should be delete[].
+}
+
+int
+ state_queue::BytesForOneState(void)
+{
+
+#ifdef VER_PSEUDO
+  // Pseudo ver: ptr + malloced state + approx. malloc&new overhead.
+  return sizeof(state *) + sizeof(state) + 8;
+#elif defined(HASHC)
+  // the hash table keeps no states, so the queues hold copies
+  return sizeof(state *) + sizeof(state);
+#else
+  return sizeof(state *);	/* Full ver: only a ptr to state. */
+#endif
+}
+
+void state_queue::Print(void)
+{
+  unsigned long i;
+  unsigned long ind = front;
+  for (i = 1; i < num_elts; i++) {
+    // convert to print in unsigned long format?
+    cout << "State " << i << " [" << ind << "]:\n";
+    stateArray[ind]->print();
+    ind = (ind + 1) % max_active_states;
+  }
+}
+
+void state_queue::enqueue(state * e)
+{
+  if (num_elts < max_active_states) {
+    stateArray[rear] = e;
+    rear = (rear + 1) % max_active_states;
+    num_elts++;
+  } else {
+    Error.Notrace("Internal Error: Too many active states.");
+  }
+}
+
+state *state_queue::dequeue(void)
+{
+  state *retval;
+  if (num_elts > 0) {
+    retval = stateArray[front];
+    front = (front + 1) % max_active_states;
+    num_elts--;
+  } else {
+    Error.Notrace("Internal: Attempt to dequeue from empty state queue.",
+		  "", "");
+  }
+  return retval;
+}
+
+state *state_queue::top(void)
+{
+  if (num_elts > 0) {
+    return stateArray[front];
+  } else {
+    Error.Notrace("Internal: Attempt to top() empty state queue.", "", "");
+    return NULL;
+  }
+}
+
+void state_stack::enqueue(state * e)
+{
+  if (num_elts < max_active_states) {
+    front = front == 0 ? max_active_states - 1 : front - 1;
+    stateArray[front] = e;
+    nextrule_to_try[front] = 0;
+    num_elts++;
+  } else {
+    Error.Notrace("Internal: Too many active states.");
+  }
+}
+
+/****************************************
+  The Stateset implementation for recording all the states found.
+  ****************************************/
+
+int state_set::bits_per_state()
+{
+#ifndef HASHC
+  return 8 * sizeof(slot);
+#else
+  // signatures take a whole word whatever their number of bits
+  return 8 * sizeof(unsigned long);
+#endif
+}
+
+#ifndef HASHC
+state_set::state_set(unsigned long table_size)
+:  
+table_size(table_size)
+{
+  table = (slot *) shared_alloc(table_size * sizeof(slot));
+  cnt = (counters *) shared_alloc(sizeof(counters));
+}
+
+state_set::~state_set()
+{
+  shared_free(table, table_size * sizeof(slot));
+  shared_free(cnt, sizeof(counters));
+}
+#else
+state_set::state_set(unsigned long table_size)
+:  
+table_size(table_size),
+num_buckets((table_size + BUCKET_SIZE - 1) / BUCKET_SIZE)
+{
+  if (args->print_64bit_info.value) {
+    printf
+	("With %lu bytes of RAM, you can use at most %d bits (option -b) for the hash compaction\n",
+	 args->mem.value, 64);
+    exit(1);
+  }
+  table = (bucket *) shared_alloc(num_buckets * sizeof(bucket));
+  cnt = (counters *) shared_alloc(sizeof(counters));
+}
+
+state_set::~state_set()
+{
+  shared_free(table, num_buckets * sizeof(bucket));
+  shared_free(cnt, sizeof(counters));
+}
+#endif
+
+#ifndef HASHC
+unsigned long state_set::key(state * in)
+{
+  // hashkey() only sums the words, which clusters badly under linear
+  // probing; mix every word instead
+  unsigned long h = 0x9e3779b97f4a7c15UL;
+  unsigned long *pt = (unsigned long *) in->bits;
+
+  for (int i = BLOCKS_IN_WORLD >> LOG2_UL; i > 0; i--) {
+    h = (h ^ *pt++) * 0xff51afd7ed558ccdUL;
+    h ^= h >> 32;
+  }
+  // keep clear of EMPTY and BUSY
+  return h | 2;
+}
+
+bool state_set::simple_was_present(state * &in, bool valid, bool permanent)
+/* changes in to point to the first state found with that pattern. */
+/* returns true iff the state was present in the hash table;
+ * Otherwise, returns false and inserts the state. */
+{
+  unsigned long k = key(in);
+  unsigned long h = k % table_size;
+  unsigned long probe;
+
+  for (probe = 0; probe < table_size; probe++) {
+    slot & e = table[h];
+    unsigned long t = e.tag.load(std::memory_order_acquire);
+
+    if (t == EMPTY) {
+      unsigned long expected = EMPTY;
+      if (e.tag.compare_exchange_strong(expected, BUSY,
+					std::memory_order_acquire)) {
+	/* Go ahead and insert the element. */
+	e.s = *in;
+	e.tag.store(k, std::memory_order_release);
+	in = &e.s;
+	cnt->num_elts++;
+	if (permanent)
+	  cnt->num_elts_reduced++;
+	return FALSE;
+      }
+      t = expected;
+    }
+    // another worker is storing a state here; wait for its key
+    while (t == BUSY) {
+      sched_yield();
+      t = e.tag.load(std::memory_order_acquire);
+    }
+    if (t == k && *in == e.s) {
+      in = &e.s;
+      return TRUE;
+    }
+    h = h + 1 == table_size ? 0 : h + 1;	// linear probing
+    cnt->num_collisions.fetch_add(1, std::memory_order_relaxed);
+  }
+  Error.Notrace("Closed hash table full.");
+  return FALSE;			/* it doesn\'t matter, but it shuts up g++. */
+};
+#else
+bool state_set::simple_was_present(state * &in, bool valid, bool permanent)
+/* returns true iff the signature of in was present in the hash table;
+ * Otherwise, returns false and inserts the signature. */
+{
+  unsigned int *key = h3->hash(in, valid);
+  unsigned long num_bits = args->num_bits.value;
+
+  // the signature takes the same bits of key[1] and key[2] as the
+  // trace info file (see StatePtr::compare); key[0] picks the bucket
+  unsigned int c1 = key[1] & ((~0U) << (num_bits > BITUNSIGNED ? 0 :
+					 BITUNSIGNED - num_bits));
+  unsigned int c2 = key[2] & (num_bits > BITUNSIGNED ?
+			      (~0U) << (2 * BITUNSIGNED - num_bits) : 0);
+  unsigned long sig = (unsigned long) c1 << BITUNSIGNED | c2;
+  if (sig == EMPTY)
+    sig = 1;
+  unsigned long b = key[0] % num_buckets;
+  unsigned long compared = 0;
+
+  for (unsigned long probe = 0; probe < num_buckets; probe++) {
+    bucket & e = table[b];
+    for (int i = 0; i < BUCKET_SIZE; i++) {
+      unsigned long t = e.sig[i].load(std::memory_order_relaxed);
+
+      if (t == EMPTY) {
+	if (e.sig[i].compare_exchange_strong(t, sig,
+					     std::memory_order_relaxed)) {
+	  /* Go ahead and insert the element. */
+	  if (args->trace_file.value)
+	    TraceFile->write(c1, c2, in->previous.lVal());
+	  cnt->num_elts++;
+	  if (permanent)
+	    cnt->num_elts_reduced++;
+	  cnt->num_compared.fetch_add(compared, std::memory_order_relaxed);
+	  return FALSE;
+	}
+	// another worker took the entry; t holds its signature now
+      }
+      if (t == sig)
+	return TRUE;
+      compared++;
+    }
+    // buckets fill from the left, so only a full one sends us on
+    b = b + 1 == num_buckets ? 0 : b + 1;
+    cnt->num_collisions.fetch_add(1, std::memory_order_relaxed);
+  }
+  Error.Notrace("Closed hash table full.");
+  return FALSE;			/* it doesn\'t matter, but it shuts up g++. */
+};
+#endif
+
+bool state_set::was_present(state * &in, bool valid, bool permanent)
+{
+  if (args->symmetry_reduction.value)
+    in->Normalize();
+  if (args->multiset_reduction.value && !args->symmetry_reduction.value)
+    in->MultisetSort();
+  return simple_was_present(in, valid, permanent);
+}
+
+void state_set::print_capacity(void)
+{
+  cout <<
+      "\t* The memory allocated for the hash table and state queue is\n\t  ";
+  if (args->mem.value > 1000000)
+    cout << (args->mem.value / 1000000) << " Mbytes.\n";
+  else
+    cout << (args->mem.value / 1000) << " kbytes.\n";
+
+#ifndef HASHC
+  cout << "\t  With one word of overhead per state, the maximum size of\n"
+      << "\t  the state space is "
+      << table_size << " states.\n"
+      <<
+      "\t   * Use option \"-k\" or \"-m\" to increase this, if necessary.\n";
+#else
+  cout << "\t  With states hash-compressed to "
+      << args->num_bits.value << " bits (one word each), the maximum\n"
+      << "\t  size of the state space is "
+      << table_size << " states.\n"
+      <<
+      "\t   * Use option \"-k\" or \"-m\" to increase this, if necessary.\n";
+#endif
+}
+
+/****************************************
+  The frontier of the parallel breadth-first search.
+  ****************************************/
+
+// states taken from a queue at a time
+#define FRONTIER_BATCH 16
+
+frontier::frontier(unsigned nworkers, unsigned long capacity)
+:nworkers(nworkers), capacity(capacity), level(0), victim(0), next(0),
+end(0)
+{
+  for (int p = 0; p < 2; p++) {
+    queues[p] = (queue *) shared_alloc(nworkers * sizeof(queue));
+    slots[p] = (entry *) shared_alloc(nworkers * capacity * sizeof(entry));
+  }
+}
+
+frontier::~frontier()
+{
+  for (int p = 0; p < 2; p++) {
+    shared_free(queues[p], nworkers * sizeof(queue));
+    shared_free(slots[p], nworkers * capacity * sizeof(entry));
+  }
+}
+
+void frontier::enqueue(unsigned me, state * e)
+{
+  queue & q = queues[(level + 1) & 1][me];
+  if (q.tail == capacity)
+    Error.Notrace("Internal Error: Too many active states.");
+#ifndef HASHC
+  slots[(level + 1) & 1][me * capacity + q.tail++] = e;
+#else
+  slots[(level + 1) & 1][me * capacity + q.tail++] = *e;
+#endif
+}
+
+bool frontier::grab(unsigned me, unsigned w)
+{
+  queue & q = queues[level & 1][w];
+  if (q.head.load(std::memory_order_relaxed) >= q.tail)
+    return FALSE;
+  unsigned long first = q.head.fetch_add(FRONTIER_BATCH);
+  if (first >= q.tail)
+    return FALSE;
+  victim = w;
+  next = first;
+  end = first + FRONTIER_BATCH < q.tail ? first + FRONTIER_BATCH : q.tail;
+  return TRUE;
+}
+
+state *frontier::dequeue(unsigned me)
+{
+  if (next == end) {
+    // own queue first, then steal from the others
+    unsigned i;
+    for (i = 0; i < nworkers; i++)
+      if (grab(me, (me + i) % nworkers))
+	break;
+    if (i == nworkers)
+      return NULL;
+  }
+#ifndef HASHC
+  return slots[level & 1][victim * capacity + next++];
+#else
+  return &slots[level & 1][victim * capacity + next++];
+#endif
+}
+
+bool frontier::next_level(unsigned me)
+{
+  // every worker is past the current level: empty our queue of it, it
+  // collects the level after the next one
+  queue & q = queues[level & 1][me];
+  q.head = 0;
+  q.tail = 0;
+  level++;
+
+  // the new level is complete and nobody appends to it any more, so
+  // all workers see the same count here
+  unsigned long n = 0;
+  for (unsigned w = 0; w < nworkers; w++)
+    n += queues[level & 1][w].tail;
+  return n > 0;
+}
+
+unsigned long frontier::NumElts(void)
+{
+  unsigned long n = 0;
+  for (unsigned w = 0; w < nworkers; w++) {
+    queue & c = queues[level & 1][w];
+    queue & f = queues[(level + 1) & 1][w];
+    unsigned long head = c.head.load(std::memory_order_relaxed);
+    n += (head < c.tail ? c.tail - head : 0) + f.tail;
+  }
+  return n;
+}
+
+/****************************************
+  The bitstate filter of the swarm search.
+  ****************************************/
+
+bitstate_filter::bitstate_filter(unsigned long bytes, unsigned long seed)
+:seed(seed)
+{
+  // the largest power of two that fits
+  for (num_words = 1; 2 * num_words * sizeof(unsigned long) <= bytes;
+       num_words *= 2);
+  bits = (std::atomic < unsigned long >*)
+      shared_alloc(num_words * sizeof(std::atomic < unsigned long >));
+  cnt = (counters *) shared_alloc(sizeof(counters));
+}
+
+bitstate_filter::~bitstate_filter()
+{
+  shared_free(bits, num_words * sizeof(std::atomic < unsigned long >));
+  shared_free(cnt, sizeof(counters));
+}
+
+void bitstate_filter::index(state * in, unsigned long &b1, unsigned long &b2)
+{
+  // mix every word, as state_set::key() does, starting from the seed
+  unsigned long h = seed * 0x9e3779b97f4a7c15UL;
+  unsigned long *pt = (unsigned long *) in->bits;
+  unsigned long mask = num_words * 8 * sizeof(unsigned long) - 1;
+
+  for (int i = BLOCKS_IN_WORLD >> LOG2_UL; i > 0; i--) {
+    h = (h ^ *pt++) * 0xff51afd7ed558ccdUL;
+    h ^= h >> 32;
+  }
+  b1 = h & mask;
+  h = (h ^ (h >> 29)) * 0xbf58476d1ce4e5b9UL;
+  b2 = (h ^ (h >> 32)) & mask;
+}
+
+bool bitstate_filter::was_present(state * in)
+{
+  unsigned long b1, b2;
+
+  if (args->symmetry_reduction.value)
+    in->Normalize();
+  if (args->multiset_reduction.value && !args->symmetry_reduction.value)
+    in->MultisetSort();
+  index(in, b1, b2);
+
+  // set both bits; the state is new if either of them was clear
+  // (do not short-circuit: both bits must end up set)
+  bool seen1 = test_and_set(b1);
+  bool seen2 = test_and_set(b2);
+  if (seen1 && seen2)
+    return TRUE;
+  cnt->num_elts++;
+  return FALSE;
+}
+
+bool bitstate_filter::is_present(state * in)
+{
+  unsigned long b1, b2;
+
+  if (args->symmetry_reduction.value)
+    in->Normalize();
+  if (args->multiset_reduction.value && !args->symmetry_reduction.value)
+    in->MultisetSort();
+  index(in, b1, b2);
+  return test(b1) && test(b2);
+}
+
+double bitstate_filter::FalsePositive()
+{
+  // each of the two bits of a new state is set with probability
+  // 1 - e^(-2n/m) after n states in m bits
+  double m = (double) num_words * BITS(unsigned long);
+  double p = 1 - exp(-2.0 * NumElts() / m);
+  return p * p;
+}
+
+void bitstate_filter::print_capacity(void)
+{
+  cout << "\t* The bitstate filter shared by the workers takes ";
+  if (num_words * sizeof(unsigned long) > 1000000)
+    cout << (num_words * sizeof(unsigned long) / 1000000) << " Mbytes";
+  else
+    cout << (num_words * sizeof(unsigned long) / 1000) << " kbytes";
+  cout << " (two bits\n\t  per state); after "
+      << num_words * BITS(unsigned long) / 20
+      << " states, one new state in a hundred\n"
+      << "\t  is taken for a state seen before.\n"
+      << "\t   * Use option \"-k\" or \"-m\" to increase this, if necessary.\n";
+}
+
+/****************************************
+  The path of a swarm worker.
+  ****************************************/
+
+state_path::state_path(unsigned long max_depth)
+:max_depth(max_depth), depth(0)
+{
+  states = new state[max_depth];
+  nextrule_to_try = new unsigned[max_depth];
+}
+
+state_path::~state_path()
+{
+  delete[]states;
+  delete[]nextrule_to_try;
+}
+
+state *state_path::push(state * e)
+{
+  if (depth == max_depth)
+    Error.Notrace("Internal: Too many states on the path.");
+  state *s = &states[depth];
+  *s = *e;
+  if (depth == 0)
+    s->previous.clear();
+  else
+    s->previous.set(&states[depth - 1]);
+  nextrule_to_try[depth++] = 0;
+  return s;
+}
+
+state *state_path::top(void)
+{
+  if (depth == 0)
+    Error.Notrace("Internal: Attempt to top() empty path.");
+  return &states[depth - 1];
+}
+
+state *state_path::pop(void)
+{
+  if (depth == 0)
+    Error.Notrace("Internal: Attempt to pop() empty path.");
+  return &states[--depth];
+}
@@ -0,0 +1,445 @@
+/**CHeaderFile*****************************************************************
+
+  FileName    [mu_state.hpp]
+
+  Synopsis    [Header file for queue and hash table]
+
+  Author      [Igor Melatti]
+
+  Copyright   [
+  This file is part of the parallel verifier package of CMurphi. 
+  Copyright (C) 2009-2012 by Sapienza University of Rome. 
+
+  CMurphi is free software; you can redistribute it and/or 
+  modify it under the terms of the GNU Lesser General Public 
+  License as published by the Free Software Foundation; either 
+  of the License, or (at your option) any later version.
+
+  CMurphi is distributed in the hope that it will be useful, 
+  but WITHOUT ANY WARRANTY; without even the implied warranty of 
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU 
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public 
+  License along with this library; if not, write to the Free Software 
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA.
+
+  To contact the CMurphi development board, email to <melatti@di.uniroma1.it>. ]
+
+******************************************************************************/
+
+#ifndef _STATE_
+#define _STATE_
+
+#include <atomic>
+
+/****************************************
+  There are six different declarations:
+  1) state
+  2) shared memory
+  3) state queue
+  4) state set
+  5) parallel frontier
+  6) swarm search: bitstate filter and path
+ ****************************************/
+
+/****************************************
+  The record for a single state.
+  require : BITS_IN_WORLD in parameter file
+ ****************************************/
+
+/* BITS_IN_WORLD gets defined by the generated code. */
+/* The extra addition is there so that we round up to the greater block. */
+
+/****************************************
+  Shared memory.
+  The workers of the parallel search are forked processes rather than
+  threads: the generated code keeps the model variables (theworld,
+  workingstate, the rule and startstate generators) in globals, so each
+  worker needs its own copy of them. Everything the workers share is
+  mapped before the fork and sits at the same address in all of them,
+  so state pointers (StatePtr) into it stay valid in every worker.
+ ****************************************/
+void *shared_alloc(unsigned long bytes);
+void shared_free(void *p, unsigned long bytes);
+
+class statelist {
+  state *s;
+  statelist *next;
+public:
+   statelist(state * s, statelist * next)
+  :s(s), next(next) {
+  };
+};
+
+/****************************************
+  The state queue.
+ ****************************************/
+class state_queue {
+protected:
+  state ** stateArray;		/* The actual array. */
+  const unsigned long max_active_states;	/* max size of queue */
+  unsigned long front;		/* index of first active state. */
+  unsigned long rear;		/* index of next free slot. */
+  unsigned long num_elts;	/* number of elements. */
+
+public:
+  // initializers
+   state_queue(unsigned long mas);
+
+  // destructor
+   virtual ~ state_queue();
+
+  // information interface
+  inline unsigned long MaxElts(void) {
+    return max_active_states;
+  } unsigned long NumElts(void) {
+    return num_elts;
+  }
+  inline static int BytesForOneState(void);
+  inline bool isempty(void) {
+    return num_elts == 0;
+  }
+
+  // storing and removing elements
+  virtual void enqueue(state * e);
+  virtual state *dequeue(void);
+  virtual state *top(void);
+
+  virtual unsigned NextRuleToTry()	// Uli: unsigned short -> unsigned
+  {
+    Error.Notrace
+	("Internal: Getting next rule to try from a state queue instead of a state stack.");
+    return 0;
+  }
+  virtual void NextRuleToTry(unsigned r) {
+    Error.Notrace
+	("Internal: Setting next rule to try from a state queue instead of a state stack.");
+  }
+
+  // printing routine
+  void Print(void);
+  virtual void print_capacity(void) {
+    cout << "\t* Capacity in queue for breadth-first search: "
+	<< max_active_states << " states.\n"
+	<<
+	"\t   * Change the constant gPercentActiveStates in mu_prolog.inc\n"
+	<< "\t     to increase this, if necessary.\n";
+  }
+};
+
+class state_stack:public state_queue {
+  unsigned *nextrule_to_try;
+
+public:
+  // initializers
+   state_stack(unsigned long mas)
+  :state_queue(mas) {
+    unsigned long i;
+     nextrule_to_try = new unsigned[mas];
+    for (i = 0; i < mas; i++)
+       nextrule_to_try[i] = 0;
+  };
+
+  // destructor
+  virtual ~ state_stack() {
+    delete[OLD_GPP(max_active_states)] nextrule_to_try;	// Should be delete[].
+  };
+
+  virtual void print_capacity(void) {
+    cout << "\t* Capacity in queue for depth-first search: "
+	<< max_active_states << " states.\n"
+	<<
+	"\t   * Change the constant gPercentActiveStates in mu_prolog.inc\n"
+	<< "\t     to increase this, if necessary.\n";
+  }
+  void enqueue(state * e);
+
+  virtual unsigned NextRuleToTry() {
+    return nextrule_to_try[front];
+  }
+  virtual void NextRuleToTry(unsigned r) {
+    nextrule_to_try[front] = r;
+  }
+
+#ifdef partial_order_opt
+  // special interface with sleepset
+  void enqueue(state * e, sleepset s);
+#endif
+};
+
+/****************************************
+  The state set
+  represented as a large open-addressed hash table in shared memory.
+  A worker claims an empty slot with a CAS on its tag, copies the state
+  in and then publishes the state's key in the tag; lookups that meet a
+  slot being filled wait for the key. No locks are taken.
+  With hash compaction (HASHC) the table only keeps a signature of
+  num_bits bits per state. Signatures sit in buckets of one cache line
+  and a worker claims an empty entry with a single CAS of the signature,
+  so a lookup usually touches one line.
+ ****************************************/
+
+class state_set {
+#ifndef HASHC
+  enum { EMPTY = 0, BUSY = 1 };
+
+  struct slot {
+    std::atomic < unsigned long >tag;	/* EMPTY, BUSY or key of s */
+    state s;
+  };
+#else
+  enum { EMPTY = 0, BUCKET_SIZE = 8 };
+
+  // one cache line of signatures, filled from the left
+  struct bucket {
+    std::atomic < unsigned long >sig[BUCKET_SIZE];	/* EMPTY or signature */
+  } __attribute__ ((aligned(64)));
+#endif
+
+  struct counters {
+    std::atomic < unsigned long >num_elts;	/* number of elements in table */
+    std::atomic < unsigned long >num_elts_reduced;	// Uli
+    std::atomic < unsigned long >num_collisions;	/* number of collisions in hashing */
+#ifdef HASHC
+    std::atomic < unsigned long >num_compared;	/* signatures met by new states */
+#endif
+  };
+
+  // data
+  unsigned long table_size;	/* max size of the hash table */
+#ifndef HASHC
+  slot *table;			/* pointer to the hash table */
+#else
+  unsigned long num_buckets;
+  bucket *table;		/* pointer to the hash table */
+#endif
+  counters *cnt;		/* shared by all workers */
+
+#ifndef HASHC
+  // internal routines
+  static unsigned long key(state * in);
+#endif
+
+public:
+  // constructors
+  state_set(unsigned long table_size);
+
+  // destructor
+  virtual ~ state_set();
+
+  // checking the presence of state "in"
+  bool simple_was_present(state * &in, bool, bool);
+  /* old was_present without checking -sym */
+  bool was_present(state * &in, bool, bool);
+  /* checking -sym before calling simple_was_present() */
+
+  // get the size of each state entry
+  static int bits_per_state(void);
+
+  // get the number of elts in the state set
+  inline unsigned long NumElts() {
+    return cnt->num_elts;
+  };
+
+  inline unsigned long NumEltsReduced() {
+    return cnt->num_elts_reduced;
+  };				// Uli
+
+#ifdef HASHC
+  // number of stored signatures compared with the ones of new states
+  inline unsigned long NumCompared() {
+    return cnt->num_compared;
+  };
+#endif
+
+  // printing information
+  void print_capacity(void);
+
+  // print hashtable       
+  void print() {
+#ifdef HASHC
+    Error.Notrace("Cannot print the states when using hash compaction.");
+#else
+    for (unsigned long i = 0; i < table_size; i++)
+      if (table[i].tag != EMPTY) {
+	cout << "State " << i << "\n";
+	StateCopy(workingstate, &table[i].s);
+	theworld.print();
+	cout << "\n";
+      }
+#endif
+  }
+};
+
+/****************************************
+  The frontier of the parallel breadth-first search.
+  The search is level-synchronous. Each worker appends the states it
+  discovers to its own queue for the next level. While a level is
+  expanded, a worker takes batches from its own queue first and then
+  steals batches from the other workers' queues. Only the owner appends
+  to a queue and batches are taken with a fetch-and-add on its head, so
+  neither side locks.
+ ****************************************/
+class frontier {
+  struct queue {
+    std::atomic < unsigned long >head;	/* next state to hand out */
+    unsigned long tail;		/* number of states in the queue */
+    char pad[64 - sizeof(std::atomic < unsigned long >) -
+	     sizeof(unsigned long)];	/* one queue per cache line */
+  };
+
+  const unsigned nworkers;
+  const unsigned long capacity;	/* states per queue */
+  queue *queues[2];		/* [level parity][worker] */
+#ifndef HASHC
+  typedef state *entry;		/* the states stay in the hash table */
+#else
+  typedef state entry;		/* the hash table keeps no states */
+#endif
+  entry *slots[2];		/* [level parity][worker * capacity + i] */
+  unsigned level;		/* level being expanded */
+
+  // the batch this worker is working through
+  unsigned victim;
+  unsigned long next, end;
+
+  bool grab(unsigned me, unsigned q);
+
+public:
+  frontier(unsigned nworkers, unsigned long capacity);
+  virtual ~ frontier();
+
+  // add a state to the next level
+  void enqueue(unsigned me, state * e);
+  // take a state of the current level; NULL when the level is done
+  state *dequeue(unsigned me);
+  // move to the next level once every worker finished the current one;
+  // false if the next level is empty
+  bool next_level(unsigned me);
+
+  unsigned long NumElts(void);
+  unsigned long Level(void) {
+    return level;
+  }
+  static int BytesForOneState(void) {
+    // the queues are reserved, not committed: only the current and
+    // the next level are backed by memory
+    return 2 * sizeof(entry);
+  }
+  void print_capacity(void) {
+    cout << "\t* Capacity in queue for breadth-first search: "
+	<< capacity << " states per worker and level.\n"
+	<<
+	"\t   * Change the constant gPercentActiveStates in mu_prolog.inc\n"
+	<< "\t     to increase this, if necessary.\n";
+  }
+};
+
+/****************************************
+  The bitstate filter of the swarm search.
+  A bit array in shared memory, in which every state sets two bits
+  picked by a hash of the state. A state counts as seen once both of
+  its bits are set, so a state can be taken for another one and be
+  missed; the fuller the filter, the likelier this is. Two workers
+  meeting a state at the same time may both claim it. All workers
+  hash with the seed of the run, so that they share what they saw.
+ ****************************************/
+class bitstate_filter {
+  struct counters {
+    std::atomic < unsigned long >num_elts;	/* states claimed */
+    std::atomic < unsigned long >num_cut;	/* states beyond the depth bound */
+  };
+
+  unsigned long num_words;	/* size of the array, a power of two */
+  std::atomic < unsigned long >*bits;
+  counters *cnt;		/* shared by all workers */
+  const unsigned long seed;
+
+  void index(state * in, unsigned long &b1, unsigned long &b2);
+  bool test(unsigned long b) {
+    return bits[b / BITS(unsigned long)].load(std::memory_order_relaxed)
+	>> (b % BITS(unsigned long)) & 1;
+  }
+  bool test_and_set(unsigned long b) {
+    unsigned long m = 1UL << (b % BITS(unsigned long));
+    return bits[b / BITS(unsigned long)].fetch_or(m,
+						  std::memory_order_relaxed)
+	& m;
+  }
+
+public:
+  bitstate_filter(unsigned long bytes, unsigned long seed);
+  virtual ~ bitstate_filter();
+
+  // true iff in has been seen; otherwise, marks it as seen
+  bool was_present(state * in);
+  // true iff in has been seen
+  bool is_present(state * in);
+  // a state was left out because its path is too long
+  void cut() {
+    cnt->num_cut.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  inline unsigned long NumElts() {
+    return cnt->num_elts;
+  }
+  inline unsigned long NumCut() {
+    return cnt->num_cut;
+  }
+  // chance that a new state is taken for a seen one
+  double FalsePositive();
+
+  void print_capacity(void);
+};
+
+/****************************************
+  The path of a swarm worker.
+  A stack of copies of the states from a start state to the state
+  being expanded, with the next rule to try in each of them. Every
+  state points to the state below it as its previous state, so the
+  path is also the error trace.
+ ****************************************/
+class state_path {
+  const unsigned long max_depth;
+  unsigned long depth;		/* number of states on the path */
+  state *states;		/* [max_depth] */
+  unsigned *nextrule_to_try;	/* [max_depth] */
+
+public:
+  state_path(unsigned long max_depth);
+  virtual ~ state_path();
+
+  inline bool isempty(void) {
+    return depth == 0;
+  }
+  inline bool isfull(void) {
+    return depth == max_depth;
+  }
+  inline unsigned long NumElts(void) {
+    return depth;
+  }
+
+  // push a copy of e; returns the copy
+  state *push(state * e);
+  state *top(void);
+  state *pop(void);
+  void clear(void) {
+    depth = 0;
+  }
+
+  unsigned NextRuleToTry() {
+    return nextrule_to_try[depth - 1];
+  }
+  void NextRuleToTry(unsigned r) {
+    nextrule_to_try[depth - 1] = r;
+  }
+
+  void print_capacity(void) {
+    cout << "\t* Capacity of the path of each worker: "
+	<< max_depth << " states.\n"
+	<< "\t   * Use option \"-depth\" to change this.\n";
+  }
+};
+
+#endif
@@ -0,0 +1,1400 @@
+/**CFile***********************************************************************
+
+  FileName    [mu_system.cpp]
+
+  Synopsis    [File for visiting procedures]
+
+  Author      [Igor Melatti]
+
+  Copyright   [
+  This file is part of the parallel verifier package of CMurphi. 
+  Copyright (C) 2009-2012 by Sapienza University of Rome. 
+
+  CMurphi is free software; you can redistribute it and/or 
+  modify it under the terms of the GNU Lesser General Public 
+  License as published by the Free Software Foundation; either 
+  of the License, or (at your option) any later version.
+
+  CMurphi is distributed in the hope that it will be useful, 
+  but WITHOUT ANY WARRANTY; without even the implied warranty of 
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU 
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public 
+  License along with this library; if not, write to the Free Software 
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA.
+
+  To contact the CMurphi development board, email to <melatti@di.uniroma1.it>. ]
+
+******************************************************************************/
+
+#include <sys/wait.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/prctl.h>
+#endif
+
+/************************************************************/
+/* StateManager */
+/************************************************************/
+StateManager::StateManager(bool createqueue, unsigned long NumStates)
+:filter(NULL), path(NULL), NumStates(NumStates),
+statesCurrentLevel(0), statesNextLevel(0), currentLevel(0), pno(1.0)
+{
+#if __WORDSIZE == 64
+  if (!args->print_64bit_info.value) {
+#endif
+    if (createqueue) {
+      levels =
+	  new frontier(Workers->NumWorkers(),
+		       (unsigned long) (gPercentActiveStates * NumStates));
+      queue = NULL;
+    } else {
+      queue =
+	  new
+	  state_stack((unsigned long) (gPercentActiveStates * NumStates));
+      levels = NULL;
+    }
+#if __WORDSIZE == 64
+  }
+#endif
+  the_states = new state_set(NumStates);
+}
+
+StateManager::StateManager(unsigned long FilterBytes,
+			   unsigned long MaxDepth, unsigned long seed)
+:the_states(NULL), queue(NULL), levels(NULL), NumStates(0),
+statesCurrentLevel(0), statesNextLevel(0), currentLevel(0), pno(1.0)
+{
+  filter = new bitstate_filter(FilterBytes, seed);
+  path = new state_path(MaxDepth);
+}
+
+StateManager::~StateManager()
+{
+  if (queue != NULL)
+    delete queue;
+  if (levels != NULL)
+    delete levels;
+  if (the_states != NULL)
+    delete the_states;
+  if (filter != NULL)
+    delete filter;
+  if (path != NULL)
+    delete path;
+}
+
+bool StateManager::Add(state * s, bool valid, bool permanent)
+{
+  if (filter != NULL) {
+    // swarm: a state beyond the depth bound is left to a shorter path
+    if (path->isfull()) {
+      filter->cut();
+      return FALSE;
+    }
+    if (filter->was_present(s))
+      return FALSE;
+    Push(s, TRUE);
+    Reporter->print_progress();
+    return TRUE;
+  }
+
+  if (!the_states->was_present(s, valid, permanent)) {
+    // Uli: invariant check moved here
+    if (!Properties->CheckInvariants()) {
+      curstate = s;
+#ifdef HASHC
+      if (args->trace_file.value)
+	NumCurState = TraceFile->numLast();
+#endif
+      Error.Deadlocked("Invariant \"%s\" failed.",
+		       Properties->LastInvariantName());
+    }
+
+    if (args->trace_all.value)
+      Reporter->print_trace_all();
+
+    statesNextLevel++;
+    if (levels != NULL)
+      levels->enqueue(Workers->Id(), s);
+    else {
+#ifdef HASHC
+      copy_state(s);		// the hash table keeps no states
+#endif
+      queue->enqueue(s);
+    }
+    Reporter->print_progress();
+    return TRUE;
+  } else
+    return FALSE;
+}
+
+// swarm: a walk goes on through the states seen before, but only
+// checks the invariants of new ones; false at the depth bound
+bool StateManager::Walk(state * s)
+{
+  if (path->isfull())
+    return FALSE;
+  Push(s, !filter->is_present(s));
+  return TRUE;
+}
+
+void StateManager::Push(state * s, bool check)
+{
+  s = path->push(s);
+  if (!check)
+    return;
+  if (!Properties->CheckInvariants()) {
+    curstate = s;
+    Error.Deadlocked("Invariant \"%s\" failed.",
+		     Properties->LastInvariantName());
+  }
+  if (args->trace_all.value)
+    Reporter->print_trace_all();
+}
+
+bool StateManager::QueueIsEmpty()
+{
+  if (path != NULL)
+    return path->isempty();
+  return queue->isempty();
+}
+
+state *StateManager::QueueTop()
+{
+  if (path != NULL)
+    return path->top();
+  return queue->top();
+}
+
+state *StateManager::QueueDequeue()
+{
+  if (levels != NULL)
+    return levels->dequeue(Workers->Id());
+  if (path != NULL)
+    return path->pop();
+  return queue->dequeue();
+}
+
+void StateManager::QueueClear()
+{
+  path->clear();
+}
+
+bool StateManager::NextLevel()
+{
+  return levels->next_level(Workers->Id());
+}
+
+unsigned StateManager::NextRuleToTry()	// Uli: unsigned short -> unsigned
+{
+  if (path != NULL)
+    return path->NextRuleToTry();
+  return queue->NextRuleToTry();
+}
+
+void StateManager::NextRuleToTry(unsigned r)
+{
+  if (path != NULL)
+    path->NextRuleToTry(r);
+  else
+    queue->NextRuleToTry(r);
+}
+
+// -------------------------------------------------------------------------
+// Uli: added omission probability calculation & printing
+
+#ifdef HASHC
+
+#include <math.h>
+
+double StateManager::harmonic(double n)
+// return harmonic number H_n
+{
+  return (n <
+	  1) ? 0 : log(n) + 0.577215665 + 1 / (2 * n) - 1 / (12 * n * n);
+}
+
+void StateManager::CheckLevel()
+// check if we are done with the level currently expanded
+{
+  static double p = 1.0;	// current bound on state omission probability
+  static double l = pow(2, double (args->num_bits.value));	// l=2^b
+  static double k = -1;		// sum of the number of states - 1
+  static double m = NumStates;	// size of the state table
+
+  if (--statesCurrentLevel <= 0)
+    // all the states of the current level have been expanded
+  {
+    // proceed to next level
+    statesCurrentLevel = statesNextLevel;
+    statesNextLevel = 0;
+
+    // check if there are states in the following level
+    if (statesCurrentLevel != 0) {
+      currentLevel++;
+
+      // calculate p_k with equation (2) from FORTE/PSTV paper for
+      // the following level
+      k += statesCurrentLevel;
+      double pk = 1 - 2 / l * (harmonic(m + 1) - harmonic(m - k))
+	  + ((2 * m) + k * (m - k)) / (m * l * (m - k + 1));
+      pno *= pk;
+    }
+  }
+}
+
+void StateManager::PrintProb()
+{
+  if (filter != NULL)
+    // a swarm search has no hash table (see print_coverage())
+    return;
+
+  // a new state is omitted only if its signature equals one of the
+  // signatures it meets on the way to its empty entry; bound this by
+  // the union over all such comparisons
+  double l = pow(2, double (args->num_bits.value));
+  double c = the_states->NumCompared();
+  double pO = c < l ? c / l : 1;
+
+  // print omission probabilities
+  cout.precision(6);
+  cout << "Omission Probabilities (caused by Hash Compaction):\n\n"
+      << "\tPr[even one omitted state]    <= " << pO << "\n";
+  // remark: the start states make up level 1 and the last level
+  // expanded was empty
+  if (levels != NULL)
+    cout << "\tDiameter of reachability graph: " << levels->Level() -
+	2 << "\n\n";
+  else
+    cout << "\n";
+}
+
+#endif
+
+// -------------------------------------------------------------------------
+
+void StateManager::print_capacity()
+{
+  if (filter != NULL) {
+    cout << "\nMemory usage:\n\n";
+    cout << "\t* The size of each state is " << BITS_IN_WORLD << " bits "
+	<< "(rounded up to " << BLOCKS_IN_WORLD << " bytes).\n";
+    filter->print_capacity();
+    path->print_capacity();
+  } else if (args->main_alg.mode == argmain_alg::Verify_dfs
+      || args->main_alg.mode == argmain_alg::Verify_bfs) {
+    cout << "\nMemory usage:\n\n";
+    cout << "\t* The size of each state is " << BITS_IN_WORLD << " bits "
+	<< "(rounded up to " << BLOCKS_IN_WORLD << " bytes).\n";
+    the_states->print_capacity();
+    if (levels != NULL)
+      levels->print_capacity();
+    else
+      queue->print_capacity();
+  }
+}
+
+void StateManager::print_coverage()
+{
+  cout << "\n\tThe swarm search is not exhaustive:\n";
+  cout.setf(ios::scientific, ios::floatfield);
+  cout << "\t* At the end, a new state was taken for one seen before\n"
+      << "\t  with probability " << filter->FalsePositive() << ".\n";
+  cout.setf(ios::fixed, ios::floatfield);
+  if (filter->NumCut() > 0)
+    cout << "\t* " << filter->NumCut()
+	<< " times, a state was beyond the depth bound.\n"
+	<< "\t   * Use option \"-depth\" to increase it.\n";
+}
+
+void StateManager::print_all_states()
+{
+  if (the_states == NULL)
+    Error.Notrace("Cannot print the states of a swarm search.");
+  the_states->print();
+}
+
+unsigned long StateManager::NumElts()
+{
+  if (filter != NULL)
+    return filter->NumElts();
+  return the_states->NumElts();
+}
+
+unsigned long StateManager::NumEltsReduced()
+{
+  if (filter != NULL)
+    return filter->NumElts();
+  return the_states->NumEltsReduced();
+}
+
+unsigned long StateManager::QueueNumElts()
+{
+  if (levels != NULL)
+    return levels->NumElts();
+  if (path != NULL)
+    return path->NumElts();
+  return queue->NumElts();
+}
+
+void StateManager::print_trace_aux(StatePtr p)	// changes by Uli
+{
+  StatePtr *steps;
+  unsigned long n = 0;
+  char *s;
+
+  // walk back to the startstate first rather than recursing: the
+  // paths of a swarm search are too deep for the stack
+  for (StatePtr q = p; !q.isStart(); q = q.previous())
+    n++;
+  steps = new StatePtr[n + 1];
+  for (unsigned long i = n; i > 0; i--) {
+    steps[i] = p;
+    p = p.previous();
+  }
+
+  // this is a startstate
+  // expand it into global variable `theworld`
+  // StateCopy(workingstate, s);   // Uli: workingstate is set in 
+  //      StateName()
+
+  // output startstate
+  cout << "Startstate " << (s = StartState->StateName(p))
+      << " fired.\n";
+  delete[]s;			// Uli: avoid memory leak
+  theworld.print();
+  cout << "----------\n\n";
+
+  // print the next states, each of which should be equivalent to
+  // the state in the trace, and set theworld to them.
+  // FALSE: no need to print full state
+  for (unsigned long i = 1; i <= n; i++)
+    Rules->print_world_to_state(steps[i], FALSE);
+  delete[]steps;
+}
+
+void StateManager::print_trace(StatePtr p)
+{
+  // print the prefix 
+  if (p.isStart()) {
+    print_trace_aux(p);
+  } else {
+    print_trace_aux(p.previous());
+
+    // print the next state, which should be equivalent to state s
+    // and set theworld to that state.
+    // TRUE: print full state please;
+    Rules->print_world_to_state(p, TRUE);
+  }
+}
+
+
+/************************************************************/
+/* StartStateManager */
+/************************************************************/
+StartStateManager::StartStateManager()
+{
+  generator = new StartStateGenerator;
+}
+
+void StartStateManager::Seed(unsigned long seed)
+{
+  random.seed(seed);
+}
+
+state *StartStateManager::RandomStartState()
+{
+  what_startstate = (unsigned short) (random.next() % numstartstates);
+  return StartState();
+}
+
+void StartStateManager::AllStartStates()
+{
+  state *nextstate = NULL;
+
+  for (what_startstate = 0; what_startstate < numstartstates;
+       what_startstate++) {
+    nextstate = StartState();	// nextstate points to internal data at theworld.getstate()
+    (void) StateSet->Add(nextstate, FALSE, TRUE);
+  }
+}
+
+state *StartStateManager::NextStartState()
+{
+  static int next_startstate = 0;
+  if (next_startstate >= numstartstates)
+    return NULL;
+  what_startstate = next_startstate++;
+  return StartState();
+}
+
+state *StartStateManager::StartState()
+{
+  state *next_state = NULL;
+
+  category = STARTSTATE;
+
+  // preparation
+  theworld.reset();
+
+  // fire state rule
+  generator->Code(what_startstate);
+
+  // print verbose message
+  if (args->verbose.value)
+    Reporter->print_fire_startstate();
+
+  // Uli: invariant check moved
+
+  // Uli: mark as startstate
+  workingstate->previous.clear();
+
+  return workingstate;
+}
+
+char *StartStateManager::LastStateName()
+{
+  return generator->Name(what_startstate);
+}
+
+char *StartStateManager::StateName(StatePtr p)
+{
+  state nextstate;
+  if (!p.isStart())
+    Error.Notrace
+	("Internal: Cannot find startstate name for non startstate");
+  for (what_startstate = 0; what_startstate < numstartstates;
+       what_startstate++) {
+    StartState();
+    StateCopy(&nextstate, workingstate);
+
+    if (StateEquivalent(&nextstate, p))
+      return LastStateName();
+  }
+
+//  Norris: it is very funny, but the following code is supposed to work, but it doesn't
+//
+//   state * nextstate;
+//   for(what_startstate=0; what_startstate<numstartstates; what_startstate++)
+//     {
+//       nextstate = StartState();                  // nextstate points to internal data at theworld.getstate()
+//       if (p.compare(nextstate))
+//      return LastStateName();
+//     }
+
+  Error.Notrace
+      ("Internal: Cannot find startstate name for funny startstate");
+  return NULL;
+}
+
+/************************************************************/
+/* RuleManager */
+/************************************************************/
+RuleManager::RuleManager():rules_fired(0), order(NULL)
+{
+  NumTimesFired = new unsigned long[RULES_IN_WORLD];
+  generator = new NextStateGenerator;
+
+  // initialize check timesfired
+  for (int i = 0; i < RULES_IN_WORLD; i++)
+    NumTimesFired[i] = 0;
+};
+
+RuleManager::~RuleManager()
+{
+  delete[OLD_GPP(RULES_IN_WORLD)] NumTimesFired;
+  if (order != NULL)
+    delete[]order;
+}
+
+void
+ RuleManager::ResetRuleNum()
+{
+  what_rule = 0;
+}
+
+void RuleManager::SetRuleNum(unsigned r)
+{
+  what_rule = r;
+}
+
+state *RuleManager::SeqNextState()
+{
+  state *ret;
+
+  what_rule = StateSet->NextRuleToTry();
+
+  generator->SetNextEnabledRule(what_rule);
+
+  if (what_rule < numrules) {
+    ret = NextState();
+    StateSet->NextRuleToTry(what_rule + 1);
+    return ret;
+  } else
+    return NULL;
+}
+
+void RuleManager::ShuffleRules(unsigned long seed)
+{
+  unsigned i, j, r;
+
+  random.seed(seed);
+  if (order == NULL)
+    order = new unsigned[numrules];
+  for (i = 0; i < numrules; i++)
+    order[i] = i;
+  // Fisher-Yates
+  for (i = numrules; i > 1; i--) {
+    j = (unsigned) (random.next() % i);
+    r = order[i - 1];
+    order[i - 1] = order[j];
+    order[j] = r;
+  }
+}
+
+state *RuleManager::SwarmNextState()
+{
+  unsigned i;
+
+  category = CONDITION;
+  for (i = StateSet->NextRuleToTry(); i < numrules; i++) {
+    what_rule = order[i];
+    if (generator->Condition(what_rule)) {
+      StateSet->NextRuleToTry(i + 1);
+      return NextState();
+    }
+  }
+  StateSet->NextRuleToTry(numrules);
+  return NULL;
+}
+
+// tries the rules in a random order, drawn as it goes, until one
+// of them leads to another state; NULL if none does
+state *RuleManager::RandomSuccessor()
+{
+  state *nextstate;
+  unsigned i, j, r;
+
+  for (i = 0; i < numrules; i++) {
+    j = i + (unsigned) (random.next() % (numrules - i));
+    r = order[j];
+    order[j] = order[i];
+    order[i] = r;
+
+    what_rule = r;
+    category = CONDITION;
+    if (generator->Condition(what_rule)) {
+      nextstate = NextState();
+      if (StateCmp(curstate, nextstate) != 0)
+	return nextstate;
+      StateCopy(workingstate, curstate);	// try another rule
+    }
+  }
+  return NULL;
+}
+
+// Uli: un-commented, fixed memory leak
+state *RuleManager::RandomNextState()
+{
+  unsigned PickARule;
+  setofrules rulesleft;
+  static state *originalstate = new state;	// buffer, for deadlock checking
+
+  // save workingstate
+  StateCopy(originalstate, workingstate);
+
+  // setup set of rules to be checked
+  rulesleft.includeall();
+
+  // nondeterministically fire rules until a different state is obtained
+  // or no rule available
+  category = CONDITION;
+
+  while (StateCmp(originalstate, curstate) == 0 && rulesleft.size() != 0) {
+    PickARule = (unsigned) (random.next() % rulesleft.size());
+    what_rule = rulesleft.getnthrule(PickARule);
+    if (generator->Condition(what_rule)) {
+      category = RULE;
+      generator->Code(what_rule);
+    }
+    curstate = workingstate;
+  }
+
+  // if deadlock occurs
+  if (!args->no_deadlock.value && StateCmp(originalstate, curstate) == 0) {
+    cout << "\nStatus:\n\n";
+    cout << "\t" << rules_fired << " rules fired in simulation in "
+	<< SecondsSinceStart() << "s.\n";
+    Error.Notrace("Deadlocked state found.");
+  }
+
+  rules_fired++;
+
+  // print verbose message
+  if (args->verbose.value & !args->full_trace.value)
+    Reporter->print_fire_rule_diff(originalstate);
+  if (args->verbose.value & args->full_trace.value)
+    Reporter->print_fire_rule();
+
+  if (!Properties->CheckInvariants()) {
+    cout << "\nStatus:\n\n";
+    cout << "\t" << rules_fired << " rules fired in simulation in "
+	<< SecondsSinceStart() << "s.\n";
+    Error.Notrace("Invariant %s failed.", Properties->LastInvariantName());
+  }
+  // progress report
+  if (!args->verbose.value
+      && rules_fired % args->progress_count.value == 0) {
+    cout << "\t" << rules_fired << " rules fired in simulation in " <<
+	SecondsSinceStart() << "s.\n";
+    cout.flush();
+  }
+  return curstate;
+}
+
+bool RuleManager::AllNextStates()
+{
+  setofrules *fire;
+
+  // get set of rules to fire
+  fire = EnabledTransition();
+
+  // generate the set of next states
+  return AllNextStates(fire);
+}
+
+/****************************************
+  Generate set of transitions to be made:
+  setofrules transitionset_enabled()
+  -- future extension
+  -- setofrules transitionset_sleepset_rr(sleepset s)
+  -- setofrules transitionset_gode_dl(setofrules rs)
+  ****************************************/
+setofrules *RuleManager::EnabledTransition()
+{
+  static setofrules ret;
+  int p;			// Priority of the current rule
+
+  ret.removeall();
+
+  // record what kind of analysis is currently carried out
+  category = CONDITION;
+
+  // Minimum priority among all rules
+  minp = INT_MAX;
+  // get enabled
+  for (what_rule = 0; what_rule < numrules; what_rule++) {
+    generator->SetNextEnabledRule(what_rule);
+    if (what_rule < numrules) {
+      ret.add(what_rule);
+
+      // Compute minimum priority
+      if ((p = generator->Priority(what_rule)) < minp)
+	minp = p;
+    }
+  }
+  return &ret;
+}
+
+/****************************************
+  The BFS verification supporting routines:
+  void generate_startstateset()
+  bool generate_nextstateset_standard(setofrules fire)
+  -- future extension
+  -- bool generate_nextstateset_sym() 
+  -- bool generate_nextstateset_gode_dl() 
+  -- bool generate_nextstateset_sleepset_rr(setofrules fire, sleepset cursleepset)
+  -- bool generate_nextstateset_gode_sleepset_dl(sleepset cursleepset)
+  ****************************************/
+
+// Uli: corrected a memory-leak, improved performance
+bool RuleManager::AllNextStates(setofrules * fire)
+{
+  // this will unconditionally fire rule in "fire"
+  // please make sure the conditions are true for the rules in "fire"
+  // before calling this function.
+
+  static state *originalstate = new state;	// buffer for workingstate
+  state *nextstate;
+  bool deadlocked_so_far = TRUE;
+  bool permanent;
+
+  StateCopy(originalstate, workingstate);	// make copy of workingstate
+
+  /*
+     for ( what_rule=0; what_rule<numrules; what_rule++)
+     {
+     if (generator->Condition(what_rule) !=
+     fire->in(what_rule)) {
+     if (!fire->in(what_rule)) {
+     cout << "Condition for rule " << what_rule << " is true ";
+     cout << "but it is not in fire!\n";
+     exit(89);
+     }
+     else {
+     cout << "Rule " << what_rule << " is in fire ";
+     cout << "but its condition is false!\n";
+     exit(99);
+     }
+     }
+     }
+   */
+
+  for (what_rule = 0; what_rule < numrules; what_rule++) {
+    if (fire->in(what_rule) && generator->Priority(what_rule) <= minp)
+      // if (fire->in(what_rule) )
+    {
+      nextstate = NextState();
+      if (StateCmp(curstate, nextstate) != 0) {
+	deadlocked_so_far = FALSE;
+	permanent = (generator->Priority(what_rule) < 50);	// Uli
+	(void) StateSet->Add(nextstate, TRUE, permanent);
+	StateCopy(workingstate, originalstate);	// restore workingstate
+      }
+    }
+  }
+  return deadlocked_so_far;
+}
+
+// the following global variables have been set:
+// theworld, curstate and what_rule
+state *RuleManager::NextState()
+{
+
+  category = RULE;
+
+  // fire rule
+  generator->Code(what_rule);
+  rules_fired++;
+
+  // update timesfired record
+  NumTimesFired[what_rule]++;
+
+  // print verbose message
+  if (args->verbose.value)
+    Reporter->print_fire_rule();
+
+  // Uli: invariant check moved
+//  if (!Properties->CheckInvariants())
+//    {
+//      Error.Error("Invariant \"%s\" failed.",Properties->LastInvariantName());
+//    }
+
+  // get next state
+#ifdef HASHC
+  if (args->trace_file.value)
+    workingstate->previous.set(NumCurState);
+  else
+#endif
+    workingstate->previous.set(curstate);
+  return workingstate;
+}
+
+void RuleManager::print_world_to_state(StatePtr p, bool fullstate)
+{
+  state original;
+  state nextstate;
+  char *s;
+
+  // save last state
+  StateCopy(&original, workingstate);
+
+  // generate next state
+  for (what_rule = 0; what_rule < numrules; what_rule++) {
+    category = CONDITION;
+    if (generator->Condition(what_rule)) {
+      category = RULE;
+      generator->Code(what_rule);
+      StateCopy(&nextstate, workingstate);
+
+      if (StateEquivalent(&nextstate, p)) {
+	// output the name of the rule and the last state in full
+	cout << "Rule "
+	    // << rules[ what_rule ].name
+	    << (s = generator->Name(what_rule))
+	    << " fired.\n";
+	delete[]s;		// Uli: avoid memory leak
+	if (fullstate)
+	  cout << "The last state of the trace (in full) is:\n";
+	if (args->full_trace.value || fullstate)
+	  theworld.print();
+	else
+	  theworld.print_diff(&original);
+	cout << "----------\n\n";
+	return;
+      } else
+	StateCopy(workingstate, &original);
+    }
+  }
+  Error.Notrace("Internal Error:print_world_to_state().");
+}
+
+char *RuleManager::LastRuleName()
+{
+  return generator->Name(what_rule);
+}
+
+unsigned long RuleManager::NumRulesFired()
+{
+  return rules_fired;
+}
+
+void RuleManager::PublishCounts(std::atomic < unsigned long >*times,
+				std::atomic < unsigned long >&fired)
+{
+  fired += rules_fired;
+  for (int i = 0; i < RULES_IN_WORLD; i++)
+    times[i] += NumTimesFired[i];
+}
+
+void RuleManager::CollectCounts(std::atomic < unsigned long >*times,
+				std::atomic < unsigned long >&fired)
+{
+  rules_fired += fired;
+  for (int i = 0; i < RULES_IN_WORLD; i++)
+    NumTimesFired[i] += times[i];
+}
+
+void RuleManager::print_rules_information()
+{
+  bool exist;
+
+  if (args->print_rule.value) {
+
+    cout << "Rules Information:\n\n";
+    for (int i = 0; i < RULES_IN_WORLD; i++)
+      cout << "\tFired " << NumTimesFired[i] << " times\t- Rule \""
+	  << generator->Name(i)
+	  << "\"\n";
+  } else {
+    for (int i = 0; i < RULES_IN_WORLD; i++)
+      if (NumTimesFired[i] == 0)
+	exist = TRUE;
+    if (exist)
+      cout << "Analysis of State Space:\n\n"
+	  << "\tThere are rules that are never fired.\n"
+	  <<
+	  "\tIf you are running with symmetry, this may be why.  Otherwise,\n"
+	  <<
+	  "\tplease run this program with \"-pr\" for the rules information.\n";
+  }
+}
+
+/************************************************************/
+/* PropertyManager */
+/************************************************************/
+PropertyManager::PropertyManager()
+{
+}
+
+bool PropertyManager::CheckInvariants()
+{
+  category = INVARIANT;
+  for (what_invariant = 0; what_invariant < numinvariants;
+       what_invariant++) {
+    if (!(*invariants[what_invariant].condition) ())
+      /* Uh oh, invariant blown. */
+    {
+      return FALSE;
+    }
+  }
+  return TRUE;
+}
+
+const char *PropertyManager::LastInvariantName()
+{
+  return invariants[what_invariant].name;
+}
+
+/************************************************************/
+/* SymmetryManager */
+/************************************************************/
+SymmetryManager::SymmetryManager()
+{
+}
+
+/************************************************************/
+/* POManager */
+/************************************************************/
+POManager::POManager()
+{
+}
+
+/************************************************************/
+/* WorkerManager */
+/************************************************************/
+// The workers are processes rather than threads: the generated code keeps
+// the world being expanded in global variables. Whatever they share is
+// mapped before forking, so it has the same address in every worker.
+WorkerManager::WorkerManager(unsigned nworkers)
+:nworkers(nworkers), me(0)
+{
+  shared = (shared_data *) shared_alloc(sizeof(shared_data));
+  shared->error_owner = -1;
+  times_fired = (std::atomic < unsigned long >*)
+      shared_alloc(RULES_IN_WORLD * sizeof(std::atomic < unsigned long >));
+  pids = new pid_t[nworkers];
+  for (unsigned w = 0; w < nworkers; w++)
+    pids[w] = 0;
+  gettimeofday(&started, NULL);
+}
+
+WorkerManager::~WorkerManager()
+{
+  shared_free(shared, sizeof(shared_data));
+  shared_free(times_fired,
+	      RULES_IN_WORLD * sizeof(std::atomic < unsigned long >));
+  delete[]pids;
+}
+
+void WorkerManager::Start()
+{
+  // whatever is still buffered would be printed once per worker
+  cout.flush();
+  fflush(stdout);
+
+  for (unsigned w = 1; w < nworkers; w++) {
+    pid_t pid = fork();
+    if (pid < 0)
+      Error.Notrace("Cannot start worker %u.", w);
+    if (pid == 0) {
+      me = w;
+#ifdef __linux__
+      // do not outlive an interrupted verifier
+      prctl(PR_SET_PDEATHSIG, SIGKILL);
+#endif
+      return;
+    }
+    pids[w] = pid;
+  }
+}
+
+bool WorkerManager::Reap(unsigned w, bool wait)
+{
+  int status;
+
+  if (pids[w] == 0)
+    return TRUE;
+  if (waitpid(pids[w], &status, wait ? 0 : WNOHANG) != pids[w])
+    return TRUE;
+  pids[w] = 0;
+  return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+bool WorkerManager::Barrier()
+{
+  if (nworkers == 1)
+    return !Stopped();
+
+  unsigned generation = shared->generation.load(std::memory_order_acquire);
+  if (shared->arrived.fetch_add(1, std::memory_order_acq_rel) + 1 ==
+      nworkers) {
+    // last one in: release the others
+    shared->arrived.store(0, std::memory_order_relaxed);
+    shared->generation.fetch_add(1, std::memory_order_release);
+    return !Stopped();
+  }
+
+  while (shared->generation.load(std::memory_order_acquire) == generation) {
+    if (Stopped())
+      return FALSE;
+    // a worker only leaves after the last barrier or after an error,
+    // so one leaving while we wait here has crashed
+    if (me == 0)
+      for (unsigned w = 1; w < nworkers; w++)
+	if (!Reap(w, FALSE) && !Stopped())
+	  Error.Notrace("Worker %u terminated unexpectedly.", w);
+    sched_yield();
+  }
+  return !Stopped();
+}
+
+double WorkerManager::ElapsedSeconds()
+{
+  struct timeval now;
+
+  gettimeofday(&now, NULL);
+  return (now.tv_sec - started.tv_sec) + (now.tv_usec -
+					  started.tv_usec) / 1e6;
+}
+
+bool WorkerManager::ClaimError()
+{
+  int owner = -1;
+
+  return shared->error_owner.compare_exchange_strong(owner, (int) me)
+      || owner == (int) me;
+}
+
+void WorkerManager::Exit(int status)
+{
+  cout.flush();
+  if (me != 0)
+    _exit(status);
+
+  // worker 0 leaves last, failing if anybody reported an error
+  for (unsigned w = 1; w < nworkers; w++)
+    (void) Reap(w, TRUE);
+  exit(Stopped()? 1 : status);
+}
+
+void WorkerManager::Finish()
+{
+  if (me != 0) {
+    Rules->PublishCounts(times_fired, shared->rules_fired);
+    cout.flush();
+    _exit(0);
+  }
+
+  for (unsigned w = 1; w < nworkers; w++)
+    if (!Reap(w, TRUE) && !Stopped())
+      Error.Notrace("Worker %u terminated unexpectedly.", w);
+  if (Stopped())
+    // the error has been reported by another worker
+    exit(1);
+  Rules->CollectCounts(times_fired, shared->rules_fired);
+}
+
+/************************************************************/
+/* AlgorithmManager */
+/************************************************************/
+AlgorithmManager::AlgorithmManager()
+{
+  // why exists? (Norris)
+  // oldnh = set_new_handler(&err_new_handler);
+
+  // create managers
+  StartState = new StartStateManager;
+  Rules = new RuleManager;
+  Properties = new PropertyManager;
+  Symmetry = new SymmetryManager;
+  PO = new POManager;
+  Reporter = new ReportManager;
+  Workers = new WorkerManager(args->threads.value);
+
+  // a swarm search prints its seed, so that it can be repeated
+  if (args->main_alg.mode == argmain_alg::Swarm && args->seed.value == 0) {
+    randomGen clock;
+    args->seed.value = clock.next();
+  }
+
+#ifdef HASHC
+  h3 = new hash_function(BLOCKS_IN_WORLD);
+#endif
+
+  Reporter->CheckConsistentVersion();
+  if (args->main_alg.mode != argmain_alg::Nothing)
+    Reporter->print_header();
+  Reporter->print_algorithm();
+
+  switch (args->main_alg.mode) {
+  case argmain_alg::Verify_bfs:
+    StateSet =
+	new StateManager(TRUE, NumStatesGivenBytes(args->mem.value));
+    StateSet->print_capacity();
+    break;
+  case argmain_alg::Verify_dfs:
+    StateSet =
+	new StateManager(FALSE, NumStatesGivenBytes(args->mem.value));
+    StateSet->print_capacity();
+    break;
+  case argmain_alg::Swarm:
+    StateSet =
+	new StateManager(args->mem.value, args->depth.value,
+			 args->seed.value);
+    StateSet->print_capacity();
+    break;
+  case argmain_alg::Simulate:
+    StateSet = NULL;
+    break;
+  default:
+    break;
+  }
+
+  if (Workers->NumWorkers() > 1
+      && args->main_alg.mode != argmain_alg::Verify_bfs
+      && args->main_alg.mode != argmain_alg::Swarm)
+    Error.Notrace
+	("Only breadth-first verification and the swarm search can use %u workers.",
+	 Workers->NumWorkers());
+
+  Reporter->print_warning();
+
+  signal(SIGFPE, &catch_div_by_zero);
+
+};
+
+/****************************************
+  The parallel BFS verification main routine:
+  the start states are generated before forking the workers; then every
+  level is expanded by all the workers together, stealing states from
+  each other's queues, and a barrier separates a level from the next.
+  ****************************************/
+void
+ AlgorithmManager::verify_bfs()
+{
+  // Use Global Variables: what_rule, curstate, theworld, queue, the_states
+  setofrules fire;		// set of rule to be fired
+  bool deadlocked;		// boolean for checking deadlock
+
+  // print verbose message
+  if (args->verbose.value)
+    Reporter->print_verbose_header();
+
+  cout.flush();
+
+  theworld.to_state(NULL);	// trick : marks variables in world
+
+  // Generate all start state
+  StartState->AllStartStates();
+
+  // they make up the first level
+  (void) StateSet->NextLevel();
+
+  Workers->Start();
+
+  // search state space
+  do {
+    // get and remove a state from the current level
+    // please make sure that global variable curstate does not change 
+    // throughout the iteration 
+    while (!Workers->Stopped()
+	   && (curstate = StateSet->QueueDequeue()) != NULL) {
+      NumCurState++;
+      StateCopy(workingstate, curstate);
+
+      // print verbose message
+      if (args->verbose.value)
+	Reporter->print_curstate();
+
+      // generate all next state 
+      deadlocked = Rules->AllNextStates();
+
+      // check deadlock 
+      if (deadlocked && !args->no_deadlock.value)
+	Error.Deadlocked("Deadlocked state found.");
+    }				// while
+  } while (Workers->Barrier() && StateSet->NextLevel());
+
+  Workers->Finish();
+  Reporter->print_final_report();
+}
+
+/****************************************
+  The DFS verification routine:
+  void verify_dfs()
+  -- not changed yet 
+  ****************************************/
+
+void AlgorithmManager::verify_dfs()
+{
+  // use global variables: what_rule, curstate, theworld, queue, the_states
+  state *nextstate;
+  bool deadlocked_so_far = TRUE;
+
+  // print verbose message
+  if (args->verbose.value)
+    Reporter->print_verbose_header();
+
+  theworld.to_state(NULL);	// trick : marks variables in world
+
+  // for each startstate start a DFS search
+  while ((curstate = StartState->NextStartState()) != NULL) {
+    (void) StateSet->Add(curstate, FALSE, TRUE);
+
+    while (!StateSet->QueueIsEmpty()) {
+      // get the last state from the stack
+      curstate = StateSet->QueueTop();
+      StateCopy(workingstate, curstate);
+
+      // l) method:
+      // get a different next state by incrementing what_rule
+      // until a rule is enabled and the new state is different from the
+      // old state or all the rules are exhausted
+      // 2) setting of varibles
+      // what_rule is set by previous iteration
+      // curstate is set at the beginning of the iteration
+      // theworld is set at the beginning of the iteration
+
+      // get next rule that is enabled and fire it
+      // set global variable what_rule
+
+      nextstate = Rules->SeqNextState();
+
+      if (nextstate != NULL) {
+	if (StateCmp(curstate, nextstate) != 0) {
+	  // curstate state does not deadlock
+	  deadlocked_so_far = FALSE;
+
+	  // check if the next state has been searched or not
+	  if (StateSet->Add(nextstate, TRUE, TRUE)) {
+	    // curstate state does not deadlock, but the next state might
+	    deadlocked_so_far = TRUE;
+	  } else {
+	    // a rule has been fired and the next state has been searched
+	    // ==> check next rule
+	    if (args->verbose.value)
+	      cout << "This state has been examined, try another rule.\n";
+	  }
+	} else if (args->verbose.value)
+	  cout << "This state has been examined, try another rule.\n";
+      } else {
+	// check deadlock
+	if (deadlocked_so_far && !args->no_deadlock.value) {
+	  if (args->verbose.value)
+	    Reporter->print_dfs_deadlock();
+	  Error.Deadlocked("Deadlocked state found.");
+	}
+	// remove explored state
+	(void) StateSet->QueueDequeue();
+
+	// print verbose message
+	if (args->verbose.value)
+	  Reporter->print_retrack();
+
+	// previous state does not deadlock, as it gives the state just removed
+	deadlocked_so_far = FALSE;
+
+#ifdef HASHC
+	delete curstate;
+#endif
+      }				// if
+    }				// while
+
+    // print verbose message
+    if (args->verbose.value)
+      cout << "------------------------------\n"
+	  << "Finished working on one statestate.\n"
+	  << "------------------------------\n";
+  }				// for
+  Reporter->print_final_report();
+}
+
+/****************************************
+  The swarm search:
+  every worker searches on its own, with its own order of the rules
+  and its own random numbers, and the workers only share a bitstate
+  filter of the states seen. The even workers (worker 0 among them)
+  search depth-first from the start states; each state is expanded by
+  the worker that claims it in the filter, so together they cover the
+  state space, up to the filter and the depth bound. The odd workers
+  walk at random through states seen or not, and check the new ones,
+  until the depth-first workers are done. The first worker to meet an
+  error prints its trace, from its own path.
+  ****************************************/
+void AlgorithmManager::swarm()
+{
+  state *nextstate;
+  bool deadlocked_so_far = TRUE;
+  unsigned long seed;
+
+  // print verbose message
+  if (args->verbose.value)
+    Reporter->print_verbose_header();
+
+  theworld.to_state(NULL);	// trick : marks variables in world
+
+  Workers->StartSearching((Workers->NumWorkers() + 1) / 2);
+  Workers->Start();
+
+  seed = (args->seed.value + Workers->Id()) * 0x9e3779b97f4a7c15UL;
+  seed ^= seed >> 32;
+  Rules->ShuffleRules(seed);
+  StartState->Seed(seed);
+
+  if (Workers->Id() % 2 == 0) {
+    // depth-first, as verify_dfs(), in this worker's order of the rules
+    while (!Workers->Stopped()
+	   && (curstate = StartState->NextStartState()) != NULL) {
+      // every depth-first worker starts from every start state
+      if (!StateSet->Add(curstate, FALSE, TRUE))
+	(void) StateSet->Walk(curstate);
+      deadlocked_so_far = TRUE;
+
+      while (!Workers->Stopped() && !StateSet->QueueIsEmpty()) {
+	curstate = StateSet->QueueTop();
+	StateCopy(workingstate, curstate);
+
+	nextstate = Rules->SwarmNextState();
+
+	if (nextstate != NULL) {
+	  if (StateCmp(curstate, nextstate) != 0) {
+	    // curstate state does not deadlock
+	    deadlocked_so_far = FALSE;
+
+	    // go on from the next state unless it has been seen
+	    if (StateSet->Add(nextstate, TRUE, TRUE))
+	      deadlocked_so_far = TRUE;
+	  }
+	} else {
+	  // check deadlock
+	  if (deadlocked_so_far && !args->no_deadlock.value)
+	    Error.Deadlocked("Deadlocked state found.");
+
+	  // remove explored state
+	  (void) StateSet->QueueDequeue();
+
+	  // previous state does not deadlock, as it gives the state just removed
+	  deadlocked_so_far = FALSE;
+	}
+      }
+      StateSet->QueueClear();
+    }
+    Workers->DoneSearching();
+  } else {
+    // random walks, each from a random start state
+    while (!Workers->Stopped() && Workers->Searching()) {
+      StateSet->QueueClear();
+      (void) StateSet->Walk(StartState->RandomStartState());
+
+      do {
+	curstate = StateSet->QueueTop();
+	StateCopy(workingstate, curstate);
+
+	nextstate = Rules->RandomSuccessor();
+
+	if (nextstate == NULL) {
+	  if (!args->no_deadlock.value)
+	    Error.Deadlocked("Deadlocked state found.");
+	  break;
+	}
+      } while (StateSet->Walk(nextstate) && !Workers->Stopped()
+	       && Workers->Searching());
+    }
+  }
+
+  Workers->Finish();
+  Reporter->print_final_report();
+}
+
+/****************************************
+  The simulation main routine:
+  void simulate()
+  ****************************************/
+
+// Uli: added required call to theworld.to_state()
+void AlgorithmManager::simulate()
+{
+  // progress report must be printed out so as to make sense 
+  // otherwise, if there is no bug, the program just run on for ever
+  // without any message.
+
+  // print verbose message
+  if (args->verbose.value)
+    Reporter->print_verbose_header();
+
+  Reporter->StartSimulation();
+
+  theworld.to_state(NULL);	// trick: marks variables in world
+
+  // GetRandomStartState will choose a Startstate randomly
+  curstate = StartState->RandomStartState();
+
+  // simulate
+  while (1) {
+    // SimulateRandomRule always executes a rule that leads to
+    // a different state.
+    curstate = Rules->RandomNextState();
+  }
+}
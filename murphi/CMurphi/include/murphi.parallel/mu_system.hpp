@@ -0,0 +1,265 @@
+/**CHeaderFile*****************************************************************
+
+  FileName    [mu_system.hpp]
+
+  Synopsis    [Header file for visiting procedures]
+
+  Author      [Igor Melatti]
+
+  Copyright   [
+  This file is part of the parallel verifier package of CMurphi. 
+  Copyright (C) 2009-2012 by Sapienza University of Rome. 
+
+  CMurphi is free software; you can redistribute it and/or 
+  modify it under the terms of the GNU Lesser General Public 
+  License as published by the Free Software Foundation; either 
+  of the License, or (at your option) any later version.
+
+  CMurphi is distributed in the hope that it will be useful, 
+  but WITHOUT ANY WARRANTY; without even the implied warranty of 
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU 
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public 
+  License along with this library; if not, write to the Free Software 
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA.
+
+  To contact the CMurphi development board, email to <melatti@di.uniroma1.it>. ]
+
+******************************************************************************/
+
+#include <sys/types.h>
+#include <sys/time.h>
+
+/************************************************************/
+
+// Uli: added omission probability calculation & printing
+
+class StateManager {
+  state_set *the_states;	// the set of states found.
+  state_queue *queue;		// the stack for active states (dfs).
+  frontier *levels;		// the queues for active states (bfs).
+  bitstate_filter *filter;	// the states seen (swarm).
+  state_path *path;		// the states being expanded (swarm).
+  unsigned long NumStates;
+
+  // Uli: for omission probability calculation
+  long statesCurrentLevel;	// number of states in the level that
+  //  is currently expanded
+  long statesNextLevel;		// number of states in the next level
+  long currentLevel;		// level that is currently expanded
+  //  (startstates: level 0)
+  double pno;			// Pr(particular state not omitted)
+
+  double harmonic(double n);	// return harmonic number H_n
+
+  void Push(state * s, bool check);	// swarm: extend the path with s
+
+public:
+   StateManager(bool createqueue, unsigned long NumStates);
+  // swarm search: a filter of the given size and a path per worker
+   StateManager(unsigned long FilterBytes, unsigned long MaxDepth,
+		unsigned long seed);
+  ~StateManager();
+
+  bool Add(state * s, bool valid, bool permanent);
+  bool Walk(state * s);		// swarm: go on to s, seen or not
+  bool QueueIsEmpty();
+  state *QueueTop();
+  state *QueueDequeue();
+  void QueueClear();		// swarm: back to a start state
+  bool NextLevel();		// bfs: go on with the next level, if any
+  unsigned NextRuleToTry();	// Uli: unsigned short -> unsigned
+  void NextRuleToTry(unsigned r);
+
+  // Uli: routines for omission probability calculation & printing
+  void CheckLevel();
+  void PrintProb();
+
+  void print_capacity();
+  void print_coverage();	// swarm: what a search without error means
+  void print_all_states();
+  void print_trace(StatePtr p);	// changes by Uli
+  void print_trace_aux(StatePtr p);
+  unsigned long NumElts();
+  unsigned long NumEltsReduced();	// Uli
+  unsigned long QueueNumElts();
+
+};
+
+// extern class StartStateGenerator;
+class StartStateGenerator;
+
+/************************************************************/
+class StartStateManager {
+  static unsigned short numstartstates;
+  unsigned short what_startstate;	// for info at Error
+  StartStateGenerator *generator;
+  randomGen random;		// Uli: random number generator
+public:
+   StartStateManager();
+  state *RandomStartState();
+  void Seed(unsigned long seed);	// swarm: this worker's random numbers
+  void AllStartStates();
+  state *NextStartState();
+  state *StartState();
+  char *LastStateName();
+  char *StateName(StatePtr p);	// changes by Uli
+};
+
+// extern class NextStateGenerator;
+class NextStateGenerator;
+
+/************************************************************/
+class RuleManager {
+  unsigned what_rule;		// for execution and info at Error
+  unsigned long rules_fired;
+  unsigned long *NumTimesFired;	/* array for storing the number
+				   of times fired for each rule */
+  NextStateGenerator *generator;
+  unsigned *order;		// swarm: the order this worker tries rules in
+
+  setofrules *EnabledTransition();
+  bool AllNextStates(setofrules * fire);
+  state *NextState();
+  randomGen random;		// Uli: random number generator
+
+  // Vitaly's additions
+  int minp;			// Minimum priority among all rules applicable
+  // in the current state
+  // End of Vitaly's additions
+
+public:
+   RuleManager();
+  ~RuleManager();
+  state *RandomNextState();
+  state *SeqNextState();
+  // swarm: seed this worker and draw its order of the rules
+  void ShuffleRules(unsigned long seed);
+  state *SwarmNextState();	// SeqNextState() in this worker's order
+  state *RandomSuccessor();	// a random step of a walk
+  bool AllNextStates();
+  void ResetRuleNum();
+  void SetRuleNum(unsigned r);
+  char *LastRuleName();
+  unsigned long NumRulesFired();
+  // parallel search: add this worker's counts to the shared ones, or
+  // the shared ones to this worker's
+  void PublishCounts(std::atomic < unsigned long >*times,
+		     std::atomic < unsigned long >&fired);
+  void CollectCounts(std::atomic < unsigned long >*times,
+		     std::atomic < unsigned long >&fired);
+  void print_rules_information();
+  void print_world_to_state(StatePtr p, bool fullstate);
+  // changes by Uli
+};
+
+/************************************************************/
+class PropertyManager {
+  unsigned short what_invariant;	// for info at Error
+public:
+   PropertyManager();
+  bool CheckInvariants();
+  const char *LastInvariantName();
+};
+
+/************************************************************/
+class SymmetryManager {
+  state_set *debug_sym_the_states;	// the set of states found without sym.
+public:
+   SymmetryManager();
+};
+
+/************************************************************/
+class POManager			// Partial Order
+{
+  rule_matrix *conflict_matrix;
+public:
+   POManager();
+};
+
+/************************************************************/
+class AlgorithmManager {
+public:
+  AlgorithmManager();
+  void verify_bfs();
+  void verify_dfs();
+  void swarm();
+  void simulate();
+};
+
+/************************************************************/
+class WorkerManager {
+  struct shared_data {
+    std::atomic < unsigned >arrived;	// workers at the barrier
+    std::atomic < unsigned >generation;	// barriers passed
+    std::atomic < int >error_owner;	// worker reporting an error, or -1
+    std::atomic < unsigned long >rules_fired;
+    std::atomic < unsigned >searching;	// swarm: workers still searching
+  };
+
+  const unsigned nworkers;
+  unsigned me;			// this worker; 0 is the original process
+  shared_data *shared;
+  std::atomic < unsigned long >*times_fired;	// [RULES_IN_WORLD]
+  pid_t *pids;			// worker 0 only: the other workers
+  struct timeval started;
+
+  bool Reap(unsigned w, bool wait);	// worker 0: false if w died
+
+public:
+  WorkerManager(unsigned nworkers);
+  ~WorkerManager();
+
+  unsigned Id() {
+    return me;
+  }
+  unsigned NumWorkers() {
+    return nworkers;
+  }
+
+  void Start();			// fork the workers
+  bool Barrier();		// false if the search was stopped
+  bool Stopped() {		// a worker is reporting an error
+    return shared->error_owner.load(std::memory_order_relaxed) >= 0;
+  }
+  double ElapsedSeconds();	// wall clock time since the start
+  bool ClaimError();		// true if this worker reports the error
+  // swarm: the depth-first workers still searching
+  void StartSearching(unsigned n) {
+    shared->searching = n;
+  }
+  void DoneSearching() {
+    shared->searching--;
+  }
+  bool Searching() {
+    return shared->searching.load(std::memory_order_relaxed) > 0;
+  }
+  void Exit(int status);	// leave after an error
+  void Finish();		// end of the search; only worker 0 returns
+};
+
+/************************************************************/
+StartStateManager *StartState;	// manager for all startstate related operation
+RuleManager *Rules;		// manager for all rule related operation
+PropertyManager *Properties;	// manager for all property related operation
+StateManager *StateSet;		// manager for all state related information
+SymmetryManager *Symmetry;	// manager for all symmetry information
+POManager *PO;			// manager for all symmetry information
+ReportManager *Reporter;	// manager for all diagnostic messages
+AlgorithmManager *Algorithm;	// manager for all algorithm related issue
+WorkerManager *Workers = NULL;	// manager for the parallel workers
+
+Error_handler Error;		// general error handler.
+argclass *args;			// the record of the arguments.
+state *curstate;		// current state at the beginning of the rule-firing
+state *const workingstate = new state;	// Uli: buffer for doing all state
+					 //      manipulation
+world_class theworld;		// the set of global variables.
+int category;			// working on startstate, rule or invariant
+
+#ifdef HASHC
+TraceFileManager *TraceFile;	// Uli: manager for trace info file
+#endif
+unsigned long NumCurState;	// Uli: number of the current state for trace 
+			       //      info file
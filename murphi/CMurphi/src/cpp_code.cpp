@@ -659,6 +659,58 @@ const char *multisetidtypedecl::generate_decl()
   return "ERROR!";
 }
 
+/* multisets up to this size are sorted by a sorting network,
+   larger ones by insertion */
+#define MULTISET_NETWORK_MAX 16
+
+void multisettypedecl::generate_multiset_sort()
+/* sorts the first current_size elements; they are compacted already.
+   The network is Batcher's merge exchange (Knuth, 5.2.2 M), whose
+   comparators are pairs i < j, so a comparator with j past
+   current_size would only see undefined slots and is skipped. */
+{
+  int n = maximum_size, t, p, q, r, d, i, count = 0;
+
+  if (n > MULTISET_NETWORK_MAX) {
+    fprintf(codefile,
+	    "    // insertion sort\n"
+	    "    for (i = 1; i < current_size; i++)\n"
+	    "      for (j = i; j > 0 && MultisetCompare(j-1,j)>0; j--)\n"
+	    "	MultisetSwap(j-1,j);\n");
+    return;
+  }
+  if (n < 2)
+    return;
+
+  for (t = 0; (1 << t) < n; t++);
+  for (int pass = 0; pass < 2; pass++) {
+    if (pass == 1)
+      fprintf(codefile,
+	      "    // sorting network\n"
+	      "    static const int network[%d][2] = {", count);
+    count = 0;
+    for (p = 1 << (t - 1); p > 0; p >>= 1)
+      for (q = 1 << (t - 1), r = 0, d = p; d > 0;
+	   d = q - p, q >>= 1, r = p)
+	for (i = 0; i < n - d; i++)
+	  if ((i & p) == r) {
+	    if (pass == 1)
+	      fprintf(codefile, "%s{%d,%d}",
+		      count == 0 ? "\n      " :
+		      count % 8 == 0 ? ",\n      " : ", ", i, i + d);
+	    count++;
+	  }
+  }
+  fprintf(codefile,
+	  "\n    };\n"
+	  "    for (int k = 0; k < %d; k++)\n"
+	  "      {\n"
+	  "	i = network[k][0];\n"
+	  "	j = network[k][1];\n"
+	  "	if (j < current_size && MultisetCompare(i,j)>0)\n"
+	  "	  MultisetSwap(i,j);\n" "      }\n", count);
+}
+
 const char *multisettypedecl::generate_decl()
 {
   if (!declared) {
@@ -680,7 +732,7 @@ const char *multisettypedecl::generate_decl()
 	);
 
     /* declare class with set_self, constructor and destructor */
-    fprintf(codefile, "class %s\n" "{\n" " public:\n" "  %s array[ %d ];\n" "  int max_size;\n" "  int current_size;\n" " public:\n" "  mu_0_boolean valid[ %d ];\n" "  char *name;\n" "  char longname[BUFFER_SIZE/4];\n" "  void set_self( const char *n, int os);\n" "  void set_self_2( const char *n, const char *n2, int os);\n" "  void set_self_ar( const char *n, const char *n2, int os);\n" "  %s (const char *n, int os): current_size(0), max_size(0) { set_self(n, os); };\n" "  %s ( void ): current_size(0), max_size(0) {};\n" "  virtual ~%s ();\n", mu_name,	/* class name */
+    fprintf(codefile, "class %s\n" "{\n" " public:\n" "  %s array[ %d ];\n" "  int max_size;\n" "  int current_size;\n" "  int offset;\n" "  bool in_world;\n" " public:\n" "  mu_0_boolean valid[ %d ];\n" "  char *name;\n" "  char longname[BUFFER_SIZE/4];\n" "  void set_self( const char *n, int os);\n" "  void set_self_2( const char *n, const char *n2, int os);\n" "  void set_self_ar( const char *n, const char *n2, int os);\n" "  %s (const char *n, int os): max_size(0), current_size(0) { set_self(n, os); };\n" "  %s ( void ): max_size(0), current_size(0), offset(0), in_world(FALSE) {};\n" "  virtual ~%s ();\n", mu_name,	/* class name */
 	    elementtype->generate_code(),	/* array elt type */
 	    maximum_size,	/* array size */
 	    maximum_size,	/* array size */
@@ -770,6 +822,7 @@ const char *multisettypedecl::generate_decl()
 	    "  void reset() { for (int i = 0; i < %d; i++) { array[i].undefine(); valid[i].value(FALSE); } current_size = 0; };\n\n"
 	    "  void to_state(state *thestate)\n"
 	    "  {\n"
+	    "    in_world = TRUE;\n"
 	    "    for (int i = 0; i < %d; i++)\n"
 	    "     {\n"
 	    "       array[i].to_state(thestate);\n"
@@ -855,41 +908,56 @@ const char *multisettypedecl::generate_decl()
 	    //      is checked
 	    "  };\n", mu_name);
 
+    /* elements in the state are compared and exchanged as packed
+       values; local copies fall back to Compare(). */
     fprintf(codefile,
-	    "  void MultisetSort()\n"
+	    "  int MultisetCompare(int i, int j)\n"
+	    "  {\n"
+	    "    if (in_world)\n"
+	    "      return workingstate->cmpbits(offset + i * %d, offset + j * %d, %d);\n"
+	    "    return Compare(array[i], array[j]);\n"
+	    "  }\n"
+	    "  void MultisetSwap(int i, int j)\n"
 	    "  {\n"
 	    "    static %s temp;\n"
 	    "\n"
-	    "    // compact\n"
+	    "    if (in_world)\n"
+	    "      workingstate->swapbits(offset + i * %d, offset + j * %d, %d);\n"
+	    "    else\n"
+	    "      {\n"
+	    "	temp = array[i];\n"
+	    "	array[i] = array[j];\n"
+	    "	array[j] = temp;\n"
+	    "      }\n"
+	    "  }\n",
+	    elementtype->getbitsalloc(), elementtype->getbitsalloc(),
+	    elementtype->getbitsalloc(), elementtype->generate_code(),
+	    elementtype->getbitsalloc(), elementtype->getbitsalloc(),
+	    elementtype->getbitsalloc());
+
+    fprintf(codefile,
+	    "  void MultisetSort()\n"
+	    "  {\n"
+	    "    // compact; the slots that are not valid are undefined,\n"
+	    "    // so an exchange moves an element and clears its slot\n"
 	    "    int i,j;\n"
 	    "    for (i = 0, j = 0; i < %d; i++)\n"
 	    "      if (valid[i].value())\n"
 	    "	{\n"
 	    "	  if (j!=i)\n"
-	    "	    array[j++] = array[i];\n"
-	    "	  else\n"
-	    "	    j++;\n"
+	    "	    {\n"
+	    "	      MultisetSwap(i,j);\n"
+	    "	      valid[j].value(TRUE);\n"
+	    "	      valid[i].value(FALSE);\n"
+	    "	    }\n"
+	    "	  j++;\n"
 	    "	}\n"
-	    "    if (j != current_size) current_size = j;\n"
-	    "    for (i = j; i < %d; i++)\n"
-	    "      array[i].undefine();\n"
-	    "    for (i = 0; i < j; i++)\n"
-	    "      valid[i].value(TRUE);\n"
-	    "    for (i = j; i < %d; i++)\n"
-	    "      valid[i].value(FALSE);\n"
-	    "\n"
-	    "    // bubble sort\n"
-	    "    for (i = 0; i < current_size; i++)\n"
-	    "      for (j = i+1; j < current_size; j++)\n"
-	    "	if (Compare(array[i],array[j])>0)\n"
-	    "	  {\n"
-	    "	    temp = array[i];\n"
-	    "	    array[i] = array[j];\n"
-	    "	    array[j] = temp;\n"
-	    "	  }\n"
-	    "  }\n",
-	    elementtype->generate_code
-	    (), maximum_size, maximum_size, maximum_size);
+	    "    current_size = j;\n"
+	    "    if (current_size < 2)\n"
+	    "      return;\n"
+	    "\n", maximum_size);
+    generate_multiset_sort();
+    fprintf(codefile, "  }\n");
 
 
     // declare procedures for all multisetcount
@@ -930,7 +998,7 @@ const char *multisettypedecl::generate_decl()
 	    /* ANOTHER EVIL TSPRINTF! */
 	    // Uli: this might have to be changed in a similar fashion as
 	    //      at LABEL1
-	    "    if (n) array[i].set_self(tsprintf(\"%%s{%%d}\", n,i), i * %d + os); else array[i].set_self(NULL, 0);\n" "  k = os + i * %d;\n" "  for(i = 0; i < %d; i++)\n", mu_name,	/* first line of format */
+	    "    if (n) array[i].set_self(tsprintf(\"%%s{%%d}\", n,i), i * %d + os); else array[i].set_self(NULL, 0);\n" "  k = os + i * %d;\n" "  offset = os;\n" "  in_world = FALSE;\n" "  for(i = 0; i < %d; i++)\n", mu_name,	/* first line of format */
 	    maximum_size,	/* for loop bound */
 	    elementtype->getbitsalloc(),	/* second arg to set_self */
 	    elementtype->getbitsalloc(),	/* second arg to set_self */
@@ -3584,12 +3652,68 @@ const char *simplerule::generate_code()
     b->generate_code();
   fprintf(codefile, "  };\n" "\n");
 
+  // generate Footprint(r)
+  if (args->partial_order) {
+    fprintf(codefile,
+	    "  void Footprint(unsigned r, footprint & fp)\n" "  {\n");
+    generate_rule_params_assignment(enclosures);
+    generate_footprint();
+    fprintf(codefile, "  }\n" "\n");
+  }
+
   // end declaration
   fprintf(codefile, "};\n");
 
   return "ERROR!";
 }
 
+/********************
+  code for the footprint of a simplerule
+  -- the global variables read and written by every instance,
+  -- for the partial order reduction
+ ********************/
+const char *poindex::generate_code() const
+{
+  switch (iclass) {
+  case Const:
+    return tsprintf("%d", value);
+  case Param:
+    return tsprintf("(int)%s", param->generate_code());
+  default:
+    return "FOOTPRINT_ANY";
+  }
+}
+
+static void generate_poaccesses(poaccess * a)
+/* in the order they have been found. */
+{
+  static const char *kinds[] = { "guard", "read", "write", "add" };
+  if (a == NULL)
+    return;
+  generate_poaccesses(a->next);
+  fprintf(codefile, "    fp.%s(%d, %s);\n",
+	  kinds[a->aclass], a->loc.var, a->loc.index.generate_code());
+}
+
+void pofootprint::generate_code()
+{
+  if (universal)
+    fprintf(codefile, "    fp.all();\n");
+  else
+    generate_poaccesses(accesses);
+}
+
+void simplerule::generate_footprint()
+{
+  pofootprint f(getclass() == Invar ? NULL : enclosures);
+  f.rule_enclosures(enclosures);
+  if (condition != NULL)
+    condition->po_footprint(&f);
+  f.end_guard();
+  f.stmts(body);
+  f.generate_code();
+}
+
 /********************
   code for startstate
  ********************/
@@ -4276,6 +4400,36 @@ int generate_ruleset()
   }
   fprintf(codefile, "  return NULL;\n");	// added by Uli
   fprintf(codefile, "}\n");
+
+  // generate Footprint(r) and InvariantFootprint()
+  if (args->partial_order) {
+    fprintf(codefile, "void Footprint(unsigned r, footprint & fp)\n" "{\n");
+    i = 0;
+    r = 0;
+    for (sr = simplerule::SimpleRuleList; sr != NULL;
+	 sr = sr->NextSimpleRule) {
+      if (sr->getclass() == rule::Simple && sr != error_rule) {
+	if (i != 0)
+	  fprintf(codefile,
+		  "  if (r>=%d && r<=%d) { R%d.Footprint(r-%d, fp); return; } \n",
+		  i, i + sr->getsize() - 1, r, i);
+	else
+	  fprintf(codefile,
+		  "  if (r<=%d) { R%d.Footprint(r-%d, fp); return; } \n",
+		  i + sr->getsize() - 1, r, i);
+	r++;
+	i += sr->getsize();
+      }
+    }
+    fprintf(codefile, "}\n");
+
+    fprintf(codefile, "void InvariantFootprint(footprint & fp)\n" "{\n");
+    for (sr = simplerule::SimpleRuleList; sr != NULL;
+	 sr = sr->NextSimpleRule)
+      if (sr->getclass() == rule::Invar)
+	sr->generate_footprint();
+    fprintf(codefile, "}\n");
+  }
   fprintf(codefile, "};\n");
   return i;
 }
@@ -4323,6 +4477,8 @@ const char *program::generate_code()
     fprintf(codefile, "#define NO_HT\n");
   if (args->trace_dfs)
     fprintf(codefile, "#define TRACE_DFS\n");
+  if (args->partial_order)
+    fprintf(codefile, "#define PARTIAL_ORDER\n");
   fprintf(codefile, "\n");
 
   // include prolog
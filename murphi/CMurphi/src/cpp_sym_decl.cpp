@@ -240,13 +240,41 @@ void multisettypedecl::generate_permute_function()
 
   elementtype->generate_permute_function();
 
-  fprintf(codefile, "void %s::Permute(PermSet& Perm, int i)\n" "{\n" "  static %s temp(\"Permute_%s\",-1);\n" "  int j;\n" "  for (j=0; j<%d; j++)\n" "    array[j].Permute(Perm, i);\n", mu_name,	// %s::Permute
-	  mu_name, mu_name,	// %s temp("Permute_%s"...
+  // the slots that are not valid are undefined and stay so
+  fprintf(codefile, "void %s::Permute(PermSet& Perm, int i)\n" "{\n" "  int j;\n" "  for (j=0; j<%d; j++)\n" "    if (valid[j].value())\n" "      array[j].Permute(Perm, i);\n", mu_name,	// %s::Permute
 	  maximum_size		// j-for
       );
   fprintf(codefile, "};\n");
 }
 
+static void generate_permute_slice(typedecl * elementtype,
+				   typedecl * indextype)
+/* moves the elements indexed by a scalarset along the permutation;
+   only that slice is copied, and nothing when it is not moved. */
+{
+  int left = indextype->getleft(), right = indextype->getright();
+  const char *perm = indextype->mu_name;
+
+  fprintf(codefile,
+	  "  for (j=%d; j<=%d; j++)\n"
+	  "    if (Perm.revperm_%s[Perm.in_%s[i]][j-%d] != j) break;\n"
+	  "  if (j<=%d)\n" "    {\n" "      for (j=%d; j<=%d; j++)\n",
+	  left, right, perm, perm, left, right, left, right);
+  if (elementtype->issimple())
+    fprintf(codefile,
+	    "        temp[j].value((*this)[j].value());\n"
+	    "      for (j=%d; j<=%d; j++)\n"
+	    "        (*this)[j].value(temp[Perm.revperm_%s[Perm.in_%s[i]][j-%d]].value());\n",
+	    left, right, perm, perm, left);
+  else
+    fprintf(codefile,
+	    "        temp[j] = (*this)[j];\n"
+	    "      for (j=%d; j<=%d; j++)\n"
+	    "        (*this)[j] = temp[Perm.revperm_%s[Perm.in_%s[i]][j-%d]];\n",
+	    left, right, perm, perm, left);
+  fprintf(codefile, "    }\n");
+}
+
 void arraytypedecl::generate_permute_function()
 {
   if (already_generated_permute_function)
@@ -262,16 +290,8 @@ void arraytypedecl::generate_permute_function()
       );
 
   if (indextype->gettypeclass() == typedecl::Scalarset
-      && indextype->getsize() > 1) {
-    if (elementtype->issimple())
-      fprintf(codefile, "  temp = *this;\n" "  for (j=%d; j<=%d; j++)\n" "     (*this)[j].value(temp[Perm.revperm_%s[Perm.in_%s[i]][j-%d]].value());", indextype->getleft(), indextype->getright(),	// j-for
-	      indextype->mu_name, indextype->mu_name, indextype->getleft()
-	  );
-    else
-      fprintf(codefile, "  temp = *this;\n" "  for (j=%d; j<=%d; j++)\n" "    (*this)[j] = temp[Perm.revperm_%s[Perm.in_%s[i]][j-%d]];", indextype->getleft(), indextype->getright(),	// j-for
-	      indextype->mu_name, indextype->mu_name, indextype->getleft()
-	  );
-  }
+      && indextype->getsize() > 1)
+    generate_permute_slice(elementtype, indextype);
 
   if (indextype->gettypeclass() == typedecl::Union
       && ((uniontypedecl *) indextype)->IsUnionWithScalarset()) {
@@ -281,16 +301,8 @@ void arraytypedecl::generate_permute_function()
     for (t = ((uniontypedecl *) indextype)->getunionmembers();
 	 t != NULL; t = t->next) {
       d = (typedecl *) t->s->getvalue();
-      if (d->gettypeclass() == typedecl::Scalarset && d->getsize() > 1) {
-	if (elementtype->issimple())
-	  fprintf(codefile, "  temp = *this;\n" "  for (j=%d; j<=%d; j++)\n" "      (*this)[j].value(temp[Perm.revperm_%s[Perm.in_%s[i]][j-%d]].value());\n", d->getleft(), d->getright(),	// j-for
-		  d->mu_name, d->mu_name, d->getleft()
-	      );
-	else
-	  fprintf(codefile, "  temp = *this;\n" "  for (j=%d; j<=%d; j++)\n" "    (*this)[j] = temp[Perm.revperm_%s[Perm.in_%s[i]][j-%d]];\n", d->getleft(), d->getright(),	// j-for
-		  d->mu_name, d->mu_name, d->getleft()
-	      );
-      }
+      if (d->gettypeclass() == typedecl::Scalarset && d->getsize() > 1)
+	generate_permute_slice(elementtype, d);
     }
   }
   fprintf(codefile, "};\n");
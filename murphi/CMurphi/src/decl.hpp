@@ -673,6 +673,7 @@ class multisettypedecl:public typedecl {
   multisetcountlist *msclist;
   multisetremovelist *msrlist;
 
+  void generate_multiset_sort();
   void generate_multiset_simple_sort();
   void generate_multiset_while(charlist * scalarsetlist);
 
@@ -796,6 +797,9 @@ public:
   virtual typedecl *getparenttype() const {
     return parent->gettype();
   };
+  designator *getparent() const {
+    return parent;
+  };
   virtual const char *getparentname() const {
     return parent->generate_code();
   };
@@ -887,6 +887,109 @@ multisetcount::multisetcount(ste * index, designator * set, expr * filter)
 
 int multisetcount::num_multisetcount = 0;
 
+/********************
+  partial order reduction footprints
+  -- the global locations an expression reads; see pofootprint
+  ********************/
+poindex expr::po_index(pofootprint * f)
+{
+  if (hasvalue())
+    return poindex(getvalue());
+  return poindex();
+}
+
+void mathexpr::po_footprint(pofootprint * f)
+{
+  arg1->po_footprint(f);
+  if (arg2 != NULL)
+    arg2->po_footprint(f);
+}
+
+void unaryexpr::po_footprint(pofootprint * f)
+{
+  if (left != NULL)
+    left->po_footprint(f);
+}
+
+void binaryexpr::po_footprint(pofootprint * f)
+{
+  if (left != NULL)
+    left->po_footprint(f);
+  if (right != NULL)
+    right->po_footprint(f);
+}
+
+void quantexpr::po_footprint(pofootprint * f)
+{
+  quantdecl *q = (quantdecl *) parameter->getvalue();
+  if (q->left != NULL)
+    q->left->po_footprint(f);
+  if (q->right != NULL)
+    q->right->po_footprint(f);
+  pofootprint::pobinding * m = f->mark();
+  f->bind(q, polocation(), poindex());
+  left->po_footprint(f);
+  f->release(m);
+}
+
+void condexpr::po_footprint(pofootprint * f)
+{
+  test->po_footprint(f);
+  left->po_footprint(f);
+  right->po_footprint(f);
+}
+
+polocation designator::po_location(pofootprint * f)
+{
+  polocation loc;
+  switch (dclass) {
+  case Base:
+    loc = f->base_location(origin->getvalue());
+    break;
+  case ArrayRef:
+    loc = left->po_location(f);
+    arrayref->po_footprint(f);
+    if (loc.var >= 0 && loc.whole) {
+      loc.index = arrayref->po_index(f);
+      loc.whole = FALSE;
+    }
+    break;
+  case FieldRef:
+    loc = left->po_location(f);
+    loc.whole = FALSE;
+    break;
+  }
+  return loc;
+}
+
+void designator::po_footprint(pofootprint * f)
+{
+  f->read(po_location(f));
+}
+
+poindex designator::po_index(pofootprint * f)
+{
+  if (hasvalue())
+    return poindex(getvalue());
+  if (dclass == Base)
+    return f->base_index(origin->getvalue());
+  return poindex();
+}
+
+void funccall::po_footprint(pofootprint * f)
+{
+  f->call(func, actuals);
+}
+
+void multisetcount::po_footprint(pofootprint * f)
+{
+  pofootprint::pobinding * m = f->mark();
+  f->bind(index->getvalue(), polocation(), poindex());
+  set->po_footprint(f);
+  filter->po_footprint(f);
+  f->release(m);
+}
+
 /********************
   Global objects. 
   ********************/
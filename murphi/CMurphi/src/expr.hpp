@@ -38,6 +38,10 @@
   3) code generation --> declaration in cpp_code.C
   ********************/
 
+class pofootprint;
+struct poindex;
+struct polocation;
+
 /********************
   class expr
   ********************/
@@ -95,6 +99,11 @@ public:
     return new stecoll;
   };
 
+  // partial order reduction
+  virtual void po_footprint(pofootprint * f) {
+  };
+  virtual poindex po_index(pofootprint * f);
+
   // code generation
   virtual const char *generate_code();
 };
@@ -118,6 +127,7 @@ myceil,
   mathexprtype getfuntype() {
     return funtype;
   };
+  virtual void po_footprint(pofootprint * f);
   virtual const char *generate_code();
 };
 
@@ -138,6 +148,7 @@ public:
   virtual stecoll *used_stes() const {
     return (left ? left->used_stes() : new stecoll);
   }
+  virtual void po_footprint(pofootprint * f);
   // code generation virtual const char *generate_code() = 0;
 };
 
@@ -162,6 +173,7 @@ public:
 
      return l;
   }
+  virtual void po_footprint(pofootprint * f);
   // code generation virtual const char *generate_code() = 0;
 };
 
@@ -289,6 +301,7 @@ public:
     // NOTE:  parameter is ignored
     return (left ? left->used_stes() : new stecoll);
   }
+  virtual void po_footprint(pofootprint * f);
   // code generation 
   virtual const char *generate_code();
 };
@@ -319,6 +332,7 @@ public:
 
      return t;
   }
+  virtual void po_footprint(pofootprint * f);
   // code generation 
   virtual const char *generate_code();
 };
@@ -367,6 +381,10 @@ public:
 
   virtual stecoll *used_stes() const;
 
+  virtual void po_footprint(pofootprint * f);
+  virtual poindex po_index(pofootprint * f);
+  polocation po_location(pofootprint * f);
+
   // code generation
   virtual const char *generate_code();
 };
@@ -414,6 +432,7 @@ struct funccall:public expr {
     // NOTE: func is ignored
     return (actuals ? actuals->used_stes() : new stecoll);
   }
+  virtual void po_footprint(pofootprint * f);
   // code generation 
   virtual const char *generate_code();
 };
@@ -472,6 +491,7 @@ public:
 
      return i;
   }
+  virtual void po_footprint(pofootprint * f);
   // code generation 
   virtual void generate_decl(multisettypedecl * mset);
   virtual void generate_procedure();
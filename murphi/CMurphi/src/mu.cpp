@@ -143,7 +143,8 @@ argclass::argclass(int ac, char **av)
 :  
 argc(ac), argv(av), print_license(FALSE), help(FALSE), checking(TRUE),
 no_compression(TRUE), hash_compression(FALSE), hash_disk(FALSE),
-hash_cache(FALSE), pmurphik(FALSE), bpctl(FALSE), noht(FALSE), trace_dfs(FALSE)
+hash_cache(FALSE), pmurphik(FALSE), bpctl(FALSE), noht(FALSE), trace_dfs(FALSE),
+partial_order(FALSE)
 {
   bool initialized_filename = FALSE;
   int i;
@@ -189,6 +190,10 @@ hash_cache(FALSE), pmurphik(FALSE), bpctl(FALSE), noht(FALSE), trace_dfs(FALSE)
 	fprintf(stderr, "Option --disk cannot be used with --trace-dfs.\n");
 	exit(1);
       }
+      if (partial_order == TRUE) {
+	fprintf(stderr, "Option --disk cannot be used with --por.\n");
+	exit(1);
+      }
       hash_disk = TRUE;
       continue;
     }
@@ -215,6 +220,10 @@ hash_cache(FALSE), pmurphik(FALSE), bpctl(FALSE), noht(FALSE), trace_dfs(FALSE)
 	fprintf(stderr, "Option --cache cannot be used with --trace-dfs.\n");
 	exit(1);
       }
+      if (partial_order == TRUE) {
+	fprintf(stderr, "Option --cache cannot be used with --por.\n");
+	exit(1);
+      }
       hash_cache = TRUE;
       continue;
     }
@@ -237,6 +246,10 @@ hash_cache(FALSE), pmurphik(FALSE), bpctl(FALSE), noht(FALSE), trace_dfs(FALSE)
 	fprintf(stderr, "Option --prob cannot be used with --trace-dfs.\n");
 	exit(1);
       }
+      if (partial_order == TRUE) {
+	fprintf(stderr, "Option --prob cannot be used with --por.\n");
+	exit(1);
+      }
       prob_rules = TRUE;
       continue;
     }
@@ -262,6 +275,10 @@ hash_cache(FALSE), pmurphik(FALSE), bpctl(FALSE), noht(FALSE), trace_dfs(FALSE)
 	fprintf(stderr, "Option --bpctl cannot be used with --trace-dfs.\n");
 	exit(1);
       }
+      if (partial_order == TRUE) {
+	fprintf(stderr, "Option --bpctl cannot be used with --por.\n");
+	exit(1);
+      }
       bpctl = TRUE;
       continue;
     }
@@ -295,6 +312,10 @@ hash_cache(FALSE), pmurphik(FALSE), bpctl(FALSE), noht(FALSE), trace_dfs(FALSE)
 	fprintf(stderr, "Option --bpctl-prob-ord cannot be used with --trace-dfs.\n");
 	exit(1);
       }
+      if (partial_order == TRUE) {
+	fprintf(stderr, "Option --bpctl-prob-ord cannot be used with --por.\n");
+	exit(1);
+      }
       bpctl = TRUE;
       bpctl_prob_ord = TRUE;
       continue;
@@ -317,6 +338,10 @@ hash_cache(FALSE), pmurphik(FALSE), bpctl(FALSE), noht(FALSE), trace_dfs(FALSE)
 	fprintf(stderr, "Option --noht cannot be used with --prob.\n");
 	exit(1);
       }
+      if (partial_order == TRUE) {
+	fprintf(stderr, "Option --noht cannot be used with --por.\n");
+	exit(1);
+      }
       noht = TRUE;
       continue;
     }
@@ -338,10 +363,44 @@ hash_cache(FALSE), pmurphik(FALSE), bpctl(FALSE), noht(FALSE), trace_dfs(FALSE)
 	fprintf(stderr, "Option --trace-dfs cannot be used with --prob.\n");
 	exit(1);
       }
+      if (partial_order == TRUE) {
+	fprintf(stderr, "Option --trace-dfs cannot be used with --por.\n");
+	exit(1);
+      }
       trace_dfs = TRUE;
       continue;
     }
 
+//partial order reduction
+    if (strcmp(av[i], "--por") == 0) {
+      if (hash_cache == TRUE) {
+	fprintf(stderr, "Option --por cannot be used with --cache.\n");
+	exit(1);
+      }
+      if (hash_disk == TRUE) {
+	fprintf(stderr, "Option --por cannot be used with --disk.\n");
+	exit(1);
+      }
+      if (prob_rules == TRUE) {
+	fprintf(stderr, "Option --por cannot be used with --prob.\n");
+	exit(1);
+      }
+      if (bpctl == TRUE) {
+	fprintf(stderr, "Option --por cannot be used with --bpctl.\n");
+	exit(1);
+      }
+      if (noht == TRUE) {
+	fprintf(stderr, "Option --por cannot be used with --noht.\n");
+	exit(1);
+      }
+      if (trace_dfs == TRUE) {
+	fprintf(stderr, "Option --por cannot be used with --trace-dfs.\n");
+	exit(1);
+      }
+      partial_order = TRUE;
+      continue;
+    }
+
     if (strcmp(av[i], "-h") == 0) {
       help = TRUE;
       PrintInfo();
@@ -444,6 +503,7 @@ void argclass::PrintOptions(void)
 \t--bpctl-prob-ord\t \tbounded probabilistic model checking considering outgoing probabilities order\n\
 \t--noht      \t\t   \tdo not store visited states (all states will be considered new)\n\
 \t--trace-dfs \t\t   \tif DFS is used, counterexample will be generated directly from stack\n\
+\t--por       \t\t   \tpartial order reduction of independent rules (BFS only)\n\
 \n\
 An argument without a leading '-' is taken to be the input filename,\n\
 \twhich must end with '.m'\n\
@@ -147,6 +147,7 @@ public:
   bool bpctl_prob_ord;		//IM: bounded probabilistic model checking with ordering on exiting probabilities
   bool noht;			//IM: test driver
   bool trace_dfs;		//IM: DFS counterexample on stack
+  bool partial_order;		// partial order reduction of the rule instances
   const bool checking;		/* runtime checking? */
   bool remove_deadrule;		// suppress code generation for dead rules
   int symmetry_algorithm_number;	// symmetry algorithm number 
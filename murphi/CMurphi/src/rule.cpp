@@ -257,6 +257,211 @@ aliasrule::aliasrule(ste * aliases, rule * rules)
 {
 }
 
+/********************
+  class pofootprint
+  ********************/
+int pofootprint::numglobals = -1;
+decl **pofootprint::globals = NULL;
+
+static int po_count_globals(ste * globals)
+{
+  int n = 0;
+  for (ste * s = globals; s != NULL; s = s->getnext()) {
+    if (s->getvalue()->getclass() == decl::Var)
+      n++;
+    if (s->getnext() == NULL || s->getnext()->getscope() != s->getscope())
+      break;
+  }
+  return n;
+}
+
+void pofootprint::number_globals()
+/* numbers the global variables in declaration order. */
+{
+  int n = po_count_globals(theprog->globals);
+  globals = new decl *[n > 0 ? n : 1];
+  numglobals = n;
+  for (ste * s = theprog->globals; s != NULL; s = s->getnext()) {
+    if (s->getvalue()->getclass() == decl::Var)
+      globals[--n] = s->getvalue();
+    if (s->getnext() == NULL || s->getnext()->getscope() != s->getscope())
+      break;
+  }
+}
+
+pofootprint::pofootprint(ste * enclosures)
+:  enclosures(enclosures), env(NULL), calls(NULL), accesses(NULL),
+in_guard(TRUE), universal(FALSE)
+{
+  if (numglobals < 0)
+    number_globals();
+}
+
+pofootprint::pobinding * pofootprint::lookup(decl * name) const
+{
+  for (pobinding * b = env; b != NULL; b = b->next)
+    if (b->name == name)
+      return b;
+  return NULL;
+}
+
+void pofootprint::bind(decl * name, polocation loc, poindex value)
+{
+  pobinding *b = new pobinding;
+  b->name = name;
+  b->loc = loc;
+  b->value = value;
+  b->next = env;
+  env = b;
+}
+
+void pofootprint::record(poaccess::poaccess_class aclass, polocation loc)
+{
+  if (universal || loc.var < 0)
+    return;
+  for (poaccess * a = accesses; a != NULL; a = a->next)
+    if (a->aclass == aclass && a->loc.var == loc.var
+	&& a->loc.index.equal(loc.index))
+      return;
+  accesses = new poaccess(aclass, loc, accesses);
+}
+
+polocation pofootprint::base_location(decl * d)
+/* the location named by an identifier; locals are not recorded. */
+{
+  pobinding *b;
+  switch (d->getclass()) {
+  case decl::Var:
+    for (int i = 0; i < numglobals; i++)
+      if (globals[i] == d)
+	return polocation(i);
+    return polocation();
+  case decl::Alias:
+  case decl::Param:
+    b = lookup(d);
+    if (b != NULL)
+      return b->loc;
+    if (d->getclass() == decl::Alias && d->getexpr()->isdesignator())
+      return ((designator *) d->getexpr())->po_location(this);
+    return polocation();
+  default:
+    return polocation();
+  }
+}
+
+poindex pofootprint::base_index(decl * d)
+/* the value of an identifier used as an array index, when it is
+   a constant or a ruleset parameter of the rule. */
+{
+  pobinding *b;
+  switch (d->getclass()) {
+  case decl::Const:
+    return poindex(d->getvalue());
+  case decl::Quant:
+    for (ste * e = enclosures;
+	 e != NULL && (e->getvalue()->getclass() == decl::Quant ||
+		       e->getvalue()->getclass() == decl::Alias ||
+		       e->getvalue()->getclass() == decl::Choose);
+	 e = e->getnext())
+      if (e->getvalue() == d)
+	return d->gettype()->gettypeclass() == typedecl::Union ?
+	    poindex() : poindex(d);
+    // fall through
+  case decl::Alias:
+  case decl::Param:
+    b = lookup(d);
+    if (b != NULL)
+      return b->value;
+    return poindex();
+  default:
+    return poindex();
+  }
+}
+
+void pofootprint::alias(decl * a)
+{
+  expr *e = a->getexpr();
+  if (e->isdesignator())
+    bind(a, ((designator *) e)->po_location(this), e->po_index(this));
+  else {
+    e->po_footprint(this);
+    bind(a, polocation(), e->po_index(this));
+  }
+}
+
+void pofootprint::call(ste * proc, exprlist * actuals)
+/* binds the formals to the actuals and walks the body.  External
+   procedures only see their arguments; recursion is not followed. */
+{
+  procdecl *p = (procdecl *) proc->getvalue();
+  for (pocall * c = calls; c != NULL; c = c->next)
+    if (c->proc == p) {
+      universal = TRUE;
+      return;
+    }
+
+  // evaluate the actuals in the caller's bindings
+  pobinding *m = mark();
+  pobinding *formals = NULL;
+  ste *f = p->params;
+  for (exprlist * a = actuals; f != NULL && a != NULL;
+       f = f->getnext(), a = a->next) {
+    pobinding *b = new pobinding;
+    b->name = f->getvalue();
+    b->next = formals;
+    formals = b;
+    if (a->undefined)
+      continue;
+    if (((param *) f->getvalue())->getparamclass() == param::Var) {
+      b->loc = ((designator *) a->e)->po_location(this);
+      if (p->extern_def)
+	write(b->loc);
+    } else {
+      a->e->po_footprint(this);
+      b->value = a->e->po_index(this);
+    }
+  }
+  while (formals != NULL) {
+    pobinding *b = formals;
+    formals = b->next;
+    b->next = env;
+    env = b;
+  }
+
+  if (!p->extern_def) {
+    pocall *c = new pocall;
+    c->proc = p;
+    c->next = calls;
+    calls = c;
+    stmts(p->body);
+    calls = c->next;
+  }
+  release(m);
+}
+
+void pofootprint::stmts(stmt * s)
+{
+  for (; s != NULL; s = s->next)
+    s->po_footprint(this);
+}
+
+void pofootprint::rule_enclosures(ste * e)
+/* binds the aliases of a rule and reads the multisets of its
+   choose parameters, outermost first. */
+{
+  if (e != NULL &&
+      (e->getvalue()->getclass() == decl::Quant ||
+       e->getvalue()->getclass() == decl::Alias ||
+       e->getvalue()->getclass() == decl::Choose)) {
+    rule_enclosures(e->getnext());
+    if (e->getvalue()->getclass() == decl::Alias)
+      alias(e->getvalue());
+    else if (e->getvalue()->getclass() == decl::Choose)
+      read(((multisetidtypedecl *) e->getvalue()->gettype())->
+	   getparent()->po_location(this));
+  }
+}
+
 /********************
   variable declaration
   ********************/
@@ -62,6 +62,121 @@ struct rule:public TNode {
   virtual const char *generate_code();
 };
 
+/********************
+  class pofootprint
+  -- the global variables a rule may read and write, used by the
+  -- partial order reduction.  A location is a global variable
+  -- with its first array index, which is kept when it is a
+  -- constant or a ruleset parameter and is unknown otherwise.
+  ********************/
+struct poindex {
+  enum poindex_class { Unknown, Const, Param };
+  poindex_class iclass;
+  int value;			/* for Const */
+  decl *param;			/* for Param: the ruleset parameter */
+
+   poindex()
+  :iclass(Unknown), value(0), param(NULL) {
+  };
+  poindex(int value)
+  :iclass(Const), value(value), param(NULL) {
+  };
+  poindex(decl * param)
+  :iclass(Param), value(0), param(param) {
+  };
+  bool equal(const poindex & i) const {
+    return iclass == i.iclass && value == i.value && param == i.param;
+  };
+  const char *generate_code() const;
+};
+
+struct polocation {
+  int var;			/* global variable number, -1 if not global */
+  bool whole;			/* no array or field selector applied yet */
+  poindex index;
+
+   polocation()
+  :var(-1), whole(FALSE) {
+  };
+  polocation(int var)
+  :var(var), whole(TRUE) {
+  };
+};
+
+struct poaccess {
+  enum poaccess_class { Guard, Read, Write, Add };
+  poaccess_class aclass;
+  polocation loc;
+  poaccess *next;
+
+   poaccess(poaccess_class aclass, polocation loc, poaccess * next)
+  :aclass(aclass), loc(loc), next(next) {
+  };
+};
+
+class pofootprint {
+public:
+  struct pobinding {
+    decl *name;
+    polocation loc;		/* for aliases and var parameters */
+    poindex value;		/* for value parameters and aliases */
+    pobinding *next;
+  };
+
+private:
+  struct pocall {
+    decl *proc;
+    pocall *next;
+  };
+
+  ste *enclosures;		/* ruleset parameters of the rule */
+  pobinding *env;
+  pocall *calls;
+  poaccess *accesses;
+  bool in_guard;
+  bool universal;		/* recursion or something not understood */
+
+  static int numglobals;
+  static decl **globals;
+  static void number_globals();
+
+  pobinding *lookup(decl * name) const;
+  void record(poaccess::poaccess_class aclass, polocation loc);
+
+public:
+   pofootprint(ste * enclosures);
+
+  // analysis
+  void bind(decl * name, polocation loc, poindex value);
+  pobinding *mark() const {
+    return env;
+  };
+  void release(pobinding * mark) {
+    env = mark;
+  };
+  polocation base_location(decl * d);
+  poindex base_index(decl * d);
+  void read(polocation loc) {
+    record(in_guard ? poaccess::Guard : poaccess::Read, loc);
+  };
+  void write(polocation loc) {
+    record(poaccess::Write, loc);
+  };
+  void add(polocation loc) {
+    record(poaccess::Add, loc);
+  };
+  void alias(decl * a);
+  void call(ste * proc, exprlist * actuals);
+  void stmts(stmt * s);
+  void rule_enclosures(ste * e);
+  void end_guard() {
+    in_guard = FALSE;
+  };
+
+  // code generation
+  void generate_code();
+};
+
 /********************
   extern variable
   ********************/
@@ -110,6 +225,7 @@ struct simplerule:rule {
 
   // code generation
   virtual const char *generate_code();
+  void generate_footprint();
 
   int CountSize(ste * enclosures);
 
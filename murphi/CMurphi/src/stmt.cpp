@@ -274,6 +274,123 @@ returnstmt::returnstmt(expr * returnexpr)
 // else printf("returnstmt::returnstmt called with something.\n");
 }
 
+/********************
+  partial order reduction footprints
+  -- the global locations a statement reads and writes; see pofootprint
+  ********************/
+void assignment::po_footprint(pofootprint * f)
+{
+  src->po_footprint(f);
+  f->write(target->po_location(f));
+}
+
+void whilestmt::po_footprint(pofootprint * f)
+{
+  test->po_footprint(f);
+  f->stmts(body);
+}
+
+void ifstmt::po_footprint(pofootprint * f)
+{
+  test->po_footprint(f);
+  f->stmts(body);
+  f->stmts(elsecode);
+}
+
+void switchstmt::po_footprint(pofootprint * f)
+{
+  switchexpr->po_footprint(f);
+  for (caselist * c = cases; c != NULL; c = c->next) {
+    for (exprlist * v = c->values; v != NULL; v = v->next)
+      if (v->e != NULL)
+	v->e->po_footprint(f);
+    f->stmts(c->body);
+  }
+  f->stmts(elsecode);
+}
+
+void forstmt::po_footprint(pofootprint * f)
+{
+  quantdecl *q = (quantdecl *) index->getvalue();
+  if (q->left != NULL)
+    q->left->po_footprint(f);
+  if (q->right != NULL)
+    q->right->po_footprint(f);
+  pofootprint::pobinding * m = f->mark();
+  f->bind(q, polocation(), poindex());
+  f->stmts(body);
+  f->release(m);
+}
+
+void proccall::po_footprint(pofootprint * f)
+{
+  f->call(procedure, actuals);
+}
+
+void clearstmt::po_footprint(pofootprint * f)
+{
+  f->write(target->po_location(f));
+}
+
+void undefinestmt::po_footprint(pofootprint * f)
+{
+  f->write(target->po_location(f));
+}
+
+void multisetaddstmt::po_footprint(pofootprint * f)
+{
+  element->po_footprint(f);
+  f->add(target->po_location(f));
+}
+
+void multisetremovestmt::po_footprint(pofootprint * f)
+{
+  polocation loc = target->po_location(f);
+  f->read(loc);
+  f->write(loc);
+  pofootprint::pobinding * m = f->mark();
+  if (index != NULL)
+    f->bind(index->getvalue(), polocation(), poindex());
+  if (criterion != NULL)
+    criterion->po_footprint(f);
+  f->release(m);
+}
+
+void assertstmt::po_footprint(pofootprint * f)
+{
+  test->po_footprint(f);
+}
+
+void putstmt::po_footprint(pofootprint * f)
+{
+  if (putexpr != NULL)
+    putexpr->po_footprint(f);
+}
+
+static void po_aliases(pofootprint * f, ste * aliases)
+/* binds the aliases in declaration order. */
+{
+  ste *next = aliases->getnext();
+  if (next != NULL && next->getscope() == aliases->getscope())
+    po_aliases(f, next);
+  f->alias(aliases->getvalue());
+}
+
+void aliasstmt::po_footprint(pofootprint * f)
+{
+  pofootprint::pobinding * m = f->mark();
+  if (aliases != NULL)
+    po_aliases(f, aliases);
+  f->stmts(body);
+  f->release(m);
+}
+
+void returnstmt::po_footprint(pofootprint * f)
+{
+  if (retexpr != NULL)
+    retexpr->po_footprint(f);
+}
+
 /********************
   variable declaration
   ********************/
@@ -40,6 +40,8 @@ public:
   stmt(void)
   :next(NULL) {
   };
+  virtual void po_footprint(pofootprint * f) {
+  };
   virtual const char *generate_code();
 };
 
@@ -65,6 +67,7 @@ struct assignment:stmt {
   designator *target;
   expr *src;
    assignment(designator * target, expr * src);
+  virtual void po_footprint(pofootprint * f);
   virtual const char *generate_code();
 };
 
@@ -73,6 +76,7 @@ struct whilestmt:stmt {
   expr *test;
   stmt *body;
    whilestmt(expr * test, stmt * body);
+  virtual void po_footprint(pofootprint * f);
   virtual const char *generate_code();
 };
 
@@ -81,6 +85,7 @@ struct ifstmt:stmt {
   stmt *body;
   stmt *elsecode;
    ifstmt(expr * test, stmt * body, stmt * elsecode = NULL);
+  virtual void po_footprint(pofootprint * f);
   virtual const char *generate_code();
 };
 
@@ -98,6 +103,7 @@ struct switchstmt:stmt {
   caselist *cases;
   stmt *elsecode;
    switchstmt(expr * switchexpr, caselist * cases, stmt * elsecode);
+  virtual void po_footprint(pofootprint * f);
   virtual const char *generate_code();
 };
 
@@ -106,6 +112,7 @@ struct forstmt:stmt {
   ste *index;
   stmt *body;
    forstmt(ste * index, stmt * body);
+  virtual void po_footprint(pofootprint * f);
   virtual const char *generate_code();
 
   // special for loop restriction for scalarset quantified loop
@@ -117,6 +124,7 @@ struct proccall:stmt {
   ste *procedure;
   exprlist *actuals;
    proccall(ste * procedure, exprlist * actuals);
+  virtual void po_footprint(pofootprint * f);
   virtual const char *generate_code();
 };
 
@@ -124,12 +132,14 @@ struct proccall:stmt {
 struct clearstmt:stmt {
   designator *target;
    clearstmt(designator * target);
+  virtual void po_footprint(pofootprint * f);
   virtual const char *generate_code();
 };
 
 struct undefinestmt:stmt {
   designator *target;
    undefinestmt(designator * target);
+  virtual void po_footprint(pofootprint * f);
   virtual const char *generate_code();
 };
 
@@ -137,6 +147,7 @@ struct multisetaddstmt:stmt {
   designator *element;
   designator *target;
    multisetaddstmt(designator * element, designator * target);
+  virtual void po_footprint(pofootprint * f);
   virtual const char *generate_code();
 };
 
@@ -153,6 +164,7 @@ struct multisetremovestmt:stmt {
 
    multisetremovestmt(ste * index, designator * target, expr * criterion);
    multisetremovestmt(expr * criterion, designator * target);
+  virtual void po_footprint(pofootprint * f);
   virtual void generate_decl(multisettypedecl * mset);
   virtual void generate_procedure();
   virtual const char *generate_code();
@@ -168,6 +180,7 @@ struct errorstmt:stmt {
 struct assertstmt:errorstmt {
   expr *test;
    assertstmt(expr * test, char *string);
+  virtual void po_footprint(pofootprint * f);
   virtual const char *generate_code();
 };
 
@@ -176,6 +189,7 @@ struct putstmt:stmt {
   char *putstring;
    putstmt(expr * putexpr);
    putstmt(char *putstring);
+  virtual void po_footprint(pofootprint * f);
   virtual const char *generate_code();
 };
 
@@ -193,6 +207,7 @@ struct aliasstmt:stmt {
   ste *aliases;
   stmt *body;
    aliasstmt(ste * aliases, stmt * body);
+  virtual void po_footprint(pofootprint * f);
   virtual const char *generate_code();
 };
 
@@ -200,6 +215,7 @@ struct aliasstmt:stmt {
 struct returnstmt:stmt {
   expr *retexpr;
    returnstmt(expr * returnexpr = NULL);
+  virtual void po_footprint(pofootprint * f);
   virtual const char *generate_code();
 };
 
@@ -13,7 +13,12 @@ import os
 import subprocess
 import sys
 import glob
-from concurrent.futures import ProcessPoolExecutor, as_completed
+import hashlib
+import json
+import math
+import re
+import time
+from concurrent.futures import ProcessPoolExecutor, FIRST_COMPLETED, wait
 
 # Define paths and flags
 MURPHIPATH = "../CMurphi"
@@ -21,17 +26,64 @@ INCLUDEPATH = os.path.join(MURPHIPATH, "include")
 SRCPATH = os.path.join(MURPHIPATH, "src")
 CFLAGS = "-O3"
 MURPHI_FLAGS = "-b"
-RUN_FLAGS = "-tv -pr -m2000"
+RUN_FLAGS = "-tv -pr"
+# Memory (-m, in MB) of a verifier whose state count is not known yet
+DEFAULT_MEM_MB = 2000
 SOURCE_DIR = "../src"
+TEMPLATE_DIR = os.path.join(SOURCE_DIR, "template")
 BUILD_DIR = "../build"
+# Workers per verifier; more than one builds against the parallel runtime
+THREADS = int(os.environ.get("MURPHI_THREADS", "1"))
+# Swarm search (-swarm, parallel runtime): the workers search in random
+# orders, share a bitstate filter of -m MB and stop at the first error
+SWARM = os.environ.get("MURPHI_SWARM", "0") == "1"
+PARALLEL = THREADS > 1 or SWARM
+if PARALLEL:
+    CFLAGS += " -DPARALLEL_MURPHI"
+if THREADS > 1:
+    RUN_FLAGS += f" -threads{THREADS}"
+if SWARM:
+    RUN_FLAGS += " -swarm"
+    DEFAULT_MEM_MB = 64
+# Partial order reduction of independent rules (mu --por, sequential BFS only)
+PARTIAL_ORDER = os.environ.get("MURPHI_POR", "0") == "1"
+if PARTIAL_ORDER:
+    if PARALLEL:
+        sys.exit("MURPHI_POR=1 cannot be used with MURPHI_THREADS or MURPHI_SWARM")
+    MURPHI_FLAGS += " --por"
+# Hash compaction (mu -c): keep a signature of this many bits per state
+# instead of the state; error traces are not printed then
+HASHC_BITS = int(os.environ.get("MURPHI_HASHC", "0"))
+if HASHC_BITS:
+    if SWARM:
+        sys.exit("MURPHI_HASHC cannot be used with MURPHI_SWARM")
+    MURPHI_FLAGS += " -c"
+    RUN_FLAGS = RUN_FLAGS.replace("-tv ", "") + f" -b{HASHC_BITS}"
+# Litmus tables: record the reachable final outcomes in one run and check
+# them here, instead of checking them in the verifier
+ENUMERATE_OUTCOMES = os.environ.get("MURPHI_OUTCOMES", "0") == "1"
+if ENUMERATE_OUTCOMES and SWARM:
+    sys.exit("MURPHI_OUTCOMES=1 cannot be used with MURPHI_SWARM")
+# Scheduler: the verifiers running at once reserve at most this many MB in
+# total (default: 80% of the physical memory)
+MEM_BUDGET_MB = int(os.environ.get("MURPHI_MEM_BUDGET",
+                    os.sysconf("SC_PAGE_SIZE") * os.sysconf("SC_PHYS_PAGES") * 8 // 10 // 1000000))
+# Scheduler: rerun the tests that passed before and did not change
+RERUN = os.environ.get("MURPHI_RERUN", "0") == "1"
+# Results of previous runs: state count, memory and runtime of each test
+RESULTS_DB = os.path.join(BUILD_DIR, "results.json")
+# A predicted -m holds twice the states found last time, plus the queues
+MEM_HEADROOM = 2
+MEM_SLACK_MB = 16
+WORKERS = max(1, 12 // THREADS)
 
 succ_commands = []
 failed_commands = []
 
-def run_command(command):
+def run_command(command, env=None):
     try:
         print(f"Running command: {' '.join(command)}")
-        subprocess.check_call(command)
+        subprocess.check_call(command, env=env)
         return "Success"
     except subprocess.CalledProcessError as e:
         print(f"Command failed with return code {e.returncode}")
@@ -43,28 +95,216 @@ def run_command(command):
 def build_cpp_from_murphi(murphi_file, cpp_file):
     if os.path.exists(murphi_file) and (not os.path.exists(cpp_file) or os.path.getmtime(murphi_file) > os.path.getmtime(cpp_file)):
         raw_file_name = os.path.splitext(murphi_file)[0]
-        run_command([os.path.join(SRCPATH, "mu"), MURPHI_FLAGS, murphi_file])
+        run_command([os.path.join(SRCPATH, "mu")] + MURPHI_FLAGS.split() + [murphi_file])
         run_command(["mv", raw_file_name + '.cpp', cpp_file])
 
 def build_executable(cpp_file, executable):
     if os.path.exists(cpp_file) and (not os.path.exists(executable) or os.path.getmtime(cpp_file) > os.path.getmtime(executable)):
-        run_command(["g++", CFLAGS, "-o", executable, cpp_file, f"-I{INCLUDEPATH}"])
+        run_command(["g++"] + CFLAGS.split() + ["-o", executable, cpp_file, f"-I{INCLUDEPATH}", f"-I{TEMPLATE_DIR}"])
 
-def run_executable(executable):
+def run_verifier(command, env=None):
+    # like run_command, but returns the measurements of the run as well
+    stats = {}
+    print(f"Running command: {' '.join(command)}")
+    try:
+        start = time.monotonic()
+        proc = subprocess.Popen(command, env=env, stdout=subprocess.PIPE,
+                                stderr=subprocess.STDOUT, text=True)
+        output = proc.stdout.read()
+        _, status, usage = os.wait4(proc.pid, 0)
+        proc.returncode = os.waitstatus_to_exitcode(status)
+        stats["seconds"] = round(time.monotonic() - start, 2)
+        stats["rss_mb"] = usage.ru_maxrss // 1000
+    except Exception as e:
+        print(f"An error occurred: {e}")
+        return f"Failed: {command}", stats, ""
+    print(output, end="")
+    match = re.search(r"(\d+) states, \d+ rules fired", output)
+    if match:
+        stats["states"] = int(match.group(1))
+    match = re.search(r"state space is (\d+) states", output)
+    if match:
+        stats["capacity"] = int(match.group(1))
+    if proc.returncode != 0:
+        print(f"Command failed with return code {proc.returncode}")
+        return f"Failed: {command}", stats, output
+    return "Success", stats, output
+
+def run_sized(executable, mem_mb, env=None):
+    # runs a verifier with -m<mem_mb>, and again with the default memory
+    # when the prediction was too small for it
+    result, stats, output = run_verifier([executable] + RUN_FLAGS.split() + [f"-m{mem_mb}"], env)
+    if result != "Success" and mem_mb < DEFAULT_MEM_MB and \
+       re.search(r"Closed hash table full|Too many active states", output):
+        print(f"{executable}: -m{mem_mb} was too small, running with -m{DEFAULT_MEM_MB}")
+        mem_mb = DEFAULT_MEM_MB
+        result, stats, output = run_verifier([executable] + RUN_FLAGS.split() + [f"-m{mem_mb}"], env)
+    stats["mem_mb"] = mem_mb
+    return result, stats
+
+def run_executable(executable, mem_mb=DEFAULT_MEM_MB):
     assert(os.path.exists(executable))
-    return run_command([executable] + RUN_FLAGS.split())
+    return run_sized(executable, mem_mb)
 
-def end_to_end(murphi_file):
+def build_model(murphi_file):
     assert(murphi_file.endswith(".m"))
-    cpp_file = os.path.splitext(os.path.join(BUILD_DIR, os.path.basename(murphi_file)))[0] + '.cpp'
+    cpp_file = os.path.splitext(os.path.join(BUILD_DIR, os.path.basename(murphi_file)))[0]
+    cpp_file += ".por" if PARTIAL_ORDER else ""
+    cpp_file += ".hc.cpp" if HASHC_BITS else ".cpp"
     build_cpp_from_murphi(murphi_file, cpp_file)
     executable = os.path.splitext(cpp_file)[0]
+    if PARALLEL:
+        executable += ".par"
     build_executable(cpp_file, executable)
-    return run_executable(executable)
+    return executable
+
+def end_to_end(murphi_file, mem_mb=DEFAULT_MEM_MB):
+    start = time.monotonic()
+    executable = build_model(murphi_file)
+    build_seconds = round(time.monotonic() - start, 2)
+    result, stats = run_executable(executable, mem_mb)
+    stats["build_seconds"] = build_seconds
+    return result, stats
+
+def shape_of_table(table_file):
+    # the shape model a litmus table was generated for (tempToMurphiSrc.py --shapes)
+    with open(table_file) as f:
+        for line in f:
+            if line.startswith("shape "):
+                return os.path.join(SOURCE_DIR, line.split()[1])
+    raise ValueError(f"No shape in {table_file}")
+
+def read_table_outcomes(table_file):
+    # {kind: {outcome: [("load", cpu, instr, val) or ("mem", adr, val)]}}
+    outcomes = {0: {}, 1: {}}
+    with open(table_file) as f:
+        for line in f:
+            words = line.split()
+            if not words:
+                continue
+            if words[0] == "outcome":
+                outcomes[int(words[1])].setdefault(int(words[2]), [])
+            elif words[0] in ("load", "mem"):
+                kind, outcome = int(words[1]), int(words[2])
+                outcomes[kind].setdefault(outcome, []).append(
+                    (words[0],) + tuple(int(w) for w in words[3:]))
+    return outcomes
+
+def read_reached_outcomes(outcome_file):
+    # one ({(cpu, instr): val}, {adr: val}) per distinct final outcome
+    reached = set()
+    with open(outcome_file) as f:
+        reached = set(line.strip() for line in f if line.strip())
+    result = []
+    for line in sorted(reached):
+        loads, mems = {}, {}
+        for item in line.split():
+            where, val = item.split("=")
+            if where.startswith("["):
+                mems[int(where[1:-1])] = int(val)
+            else:
+                cpu, instr = where.split(".")
+                loads[(int(cpu), int(instr))] = int(val)
+        result.append((loads, mems))
+    return result
+
+def outcome_reached(conds, reached):
+    for loads, mems in reached:
+        if all(loads.get((c[1], c[2])) == c[3] if c[0] == "load" else mems.get(c[1]) == c[2]
+               for c in conds):
+            return True
+    return False
+
+def check_outcomes(table_file, outcome_file):
+    table_outcomes = read_table_outcomes(table_file)
+    reached = read_reached_outcomes(outcome_file)
+    print(f"{table_file}: {len(reached)} final outcomes reached, listed in {outcome_file}")
+    for outcome, conds in sorted(table_outcomes[1].items()):
+        if outcome_reached(conds, reached):
+            print(f"{table_file}: expected outcome {outcome} appeared")
+    for outcome, conds in sorted(table_outcomes[0].items()):
+        if outcome_reached(conds, reached):
+            return f"Failed: forbidden outcome {outcome} of {table_file} reached"
+    return "Success"
+
+def run_table(table_file, mem_mb=DEFAULT_MEM_MB):
+    executable = build_model(shape_of_table(table_file))
+    print(f"Litmus table: {table_file}")
+    env = dict(os.environ, LITMUS_TABLE=table_file)
+    if not ENUMERATE_OUTCOMES:
+        return run_sized(executable, mem_mb, env)
+    outcome_file = os.path.join(BUILD_DIR, os.path.splitext(os.path.basename(table_file))[0] + ".outcomes")
+    env["LITMUS_OUTCOMES"] = outcome_file
+    result, stats = run_sized(executable, mem_mb, env)
+    if result != "Success":
+        return result, stats
+    return check_outcomes(table_file, outcome_file), stats
+
+def run_test(test_file, mem_mb):
+    return (run_table if test_file.endswith(".lit") else end_to_end)(test_file, mem_mb)
+
+def load_results():
+    if os.path.exists(RESULTS_DB):
+        with open(RESULTS_DB) as f:
+            return json.load(f)
+    return {}
+
+def save_results(results):
+    os.makedirs(BUILD_DIR, exist_ok=True)
+    with open(RESULTS_DB + ".tmp", "w") as f:
+        json.dump(results, f, indent=1, sort_keys=True)
+    os.replace(RESULTS_DB + ".tmp", RESULTS_DB)
+
+def test_key(test_file):
+    # results are kept per test and per way of building and running it
+    config = " ".join([MURPHI_FLAGS, CFLAGS, RUN_FLAGS, "outcomes" if ENUMERATE_OUTCOMES else ""])
+    return f"{os.path.basename(test_file)} [{config.strip()}]"
+
+def test_digest(test_file):
+    # a table is unchanged when the table and its shape model are
+    digest = hashlib.sha256()
+    files = [test_file, shape_of_table(test_file)] if test_file.endswith(".lit") else [test_file]
+    for name in files:
+        with open(name, "rb") as f:
+            digest.update(f.read())
+    return digest.hexdigest()
+
+def predict_mem_mb(result):
+    # -m for the states found by the last passing run, from the bytes per
+    # state of the table it had
+    if not result or not result.get("passed") or "states" not in result or not result.get("capacity"):
+        return DEFAULT_MEM_MB
+    mb_per_state = result["mem_mb"] / result["capacity"]
+    predicted = math.ceil(result["states"] * mb_per_state * MEM_HEADROOM) + MEM_SLACK_MB
+    return min(predicted, max(DEFAULT_MEM_MB, MEM_BUDGET_MB))
+
+def schedule(jobs, executor, on_done):
+    # jobs: [(test_file, mem_mb, seconds)]; starts the longest jobs first,
+    # as many as fit in the memory budget, and a job alone even if it does not
+    pending = sorted(jobs, key=lambda job: -job[2])
+    running = {}
+    reserved = 0
+    while pending or running:
+        for job in list(pending):
+            if len(running) >= WORKERS:
+                break
+            if running and reserved + job[1] > MEM_BUDGET_MB:
+                continue
+            pending.remove(job)
+            reserved += job[1]
+            running[executor.submit(run_test, job[0], job[1])] = job
+        done, _ = wait(running, return_when=FIRST_COMPLETED)
+        for future in done:
+            job = running.pop(future)
+            reserved -= job[1]
+            on_done(job[0], *future.result())
 
 def main(source_files):
     if source_files == ["all"]:
-        source_files = glob.glob(os.path.join(SOURCE_DIR, "*.*.m"))
+        source_files = [f for f in glob.glob(os.path.join(SOURCE_DIR, "*.*.m"))
+                        if ".shape_" not in f]
+    elif source_files == ["tables"]:
+        source_files = glob.glob(os.path.join(SOURCE_DIR, "*.lit"))
     elif not source_files:
         print(f"No .m files found in the directory {SOURCE_DIR}")
         return
@@ -78,15 +318,34 @@ def main(source_files):
     #         build_executable(cpp_file, executable)
     #         executables.append(executable)
 
-    with ProcessPoolExecutor(max_workers=12) as executor:
-        futures = {executor.submit(end_to_end, murphi_file): murphi_file for murphi_file in source_files}
-        for future in as_completed(futures):
-            result = future.result()
-            if "Success" in result:
-                succ_commands.append(futures[future])
-            else:
-                failed_commands.append(futures[future])
-                print(result)
+    results = load_results()
+    digests = {test_file: test_digest(test_file) for test_file in source_files}
+    jobs = []
+    for test_file in source_files:
+        previous = results.get(test_key(test_file))
+        if not RERUN and previous and previous["passed"] and previous["digest"] == digests[test_file]:
+            print(f"Skipped (unchanged since it passed): {test_file}")
+            succ_commands.append(test_file)
+            continue
+        # tests never run go first, they may be the longest
+        seconds = previous["seconds"] if previous and "seconds" in previous else math.inf
+        jobs.append((test_file, predict_mem_mb(previous), seconds))
+
+    def on_done(test_file, result, stats):
+        if "Success" in result:
+            succ_commands.append(test_file)
+        else:
+            failed_commands.append(test_file)
+            print(result)
+        results[test_key(test_file)] = dict(stats, digest=digests[test_file],
+                                            passed="Success" in result)
+        save_results(results)
+
+    with ProcessPoolExecutor(max_workers=WORKERS) as executor:
+        # each shape is compiled once, before the tables using it run
+        shapes = {shape_of_table(f) for f, _, _ in jobs if f.endswith(".lit")}
+        list(executor.map(build_model, shapes))
+        schedule(jobs, executor, on_done)
 
 if __name__ == "__main__":
     if len(sys.argv) < 2:
@@ -95,6 +354,8 @@ if __name__ == "__main__":
         pass
     else:
         source_files = sys.argv[1:]
+        start = time.monotonic()
         main(source_files)
         print("Passed:", succ_commands)
         print("Failed:", failed_commands)
+        print(f"Batch wall time: {time.monotonic() - start:.1f}s")
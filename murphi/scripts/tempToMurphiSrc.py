@@ -23,6 +23,12 @@ temp_add_one_instr = "AddOneInstr.m"
 temp_check_outcome = "CheckOneOutcome.m"
 temp_check_one_load = "CheckOneLoad.m"
 temp_check_one_val = "CheckOneAddrVal.m"
+temp_table_decls = "TableDecls.m"
+temp_table_add_instr = "TableAddInstr.m"
+temp_table_outcome = "TableOutcome.m"
+# Config values that only select what goes into a litmus table, so they do
+# not make a new shape
+table_only_vars = ["CHECK_FORBIDDEN", "CHECK_EXPECTED"]
 # temp_map_one_cpu_cache = "MapOneCPUCache.m"
 
 def read_file(file_path):
@@ -185,6 +191,8 @@ def build_murphi_src_code_form_config(config,
             map_addr_to_dir += "\t\t\treturn DIR0"
             src_code = src_code\
                 .replace("{{FUNC_BODY_ADDR_TO_DIR}}", map_addr_to_dir)
+        elif var == "LITMUS_TABLE_DECLS" or var == "RECORD_OUTCOME":
+            src_code = src_code.replace(f"{{{{{var}}}}}", "")
         elif var in config:
             # print(var)
             src_code = src_code.replace(f"{{{{{var}}}}}", str(config[var]))
@@ -193,7 +201,104 @@ def build_murphi_src_code_form_config(config,
     return src_code
 
 
-def main(murphiTempFile, configFiles):
+def enum_values(str_src_code, type_name):
+    match = re.search(type_name + r":\s*enum\s*\{(.*?)\}", str_src_code, re.S)
+    values = re.sub(r"--[^\n]*", "", match.group(1)).split(",")
+    return [value.strip() for value in values]
+
+
+def if_chain(var, results, default):
+    body = ""
+    for idx, result in enumerate(results):
+        body += f"\t\t\tif {var} = {idx} then\n\t\t\t\treturn {result};\n\t\t\tendif;\n"
+    return body + f"\t\t\treturn {default}"
+
+
+def shape_vars(str_src_code, config):
+    # the scalar config values a model is built with, in template order
+    shape = []
+    for match in re.findall(r"\{\{(.*?)\}\}", str_src_code):
+        var = match.strip()
+        if var in config and not isinstance(config[var], (list, dict)) \
+                and var not in table_only_vars and var not in shape:
+            shape.append(var)
+    return shape
+
+
+def shape_name(murphi_base_name, str_src_code, config):
+    shape = [var.split("_")[0].lower() + str(config[var])
+             for var in shape_vars(str_src_code, config)]
+    return f"{murphi_base_name}.shape_" + "_".join(shape)
+
+
+def build_murphi_shape_src_code_from_config(config,
+                                            str_src_code,
+                                            str_table_decls,
+                                            str_table_add_instr,
+                                            str_table_outcome,
+                                            ):
+    # the litmus test itself is read from a table at startup; only the
+    # shape of the config is compiled in
+    cpu_count = int(config["CPU_COUNT"])
+    dir_count = int(config["DIR_COUNT"])
+    acc_types = enum_values(str_src_code, "AccType")
+    acc_csts = enum_values(str_src_code, "AccCst")
+    table_decls = str_table_decls\
+        .replace("{{FUNC_BODY_CPU_OF_IDX}}",
+                 if_chain("idx", [f"CPU{idx}" for idx in range(cpu_count)], "CPU0"))\
+        .replace("{{FUNC_BODY_DIR_OF_IDX}}",
+                 if_chain("idx", [f"DIR{idx}" for idx in range(dir_count)], "DIR0"))\
+        .replace("{{FUNC_BODY_ACC_OF_CODE}}", if_chain("code", acc_types, acc_types[-1]))\
+        .replace("{{FUNC_BODY_CST_OF_CODE}}", if_chain("code", acc_csts, acc_csts[0]))
+    src_code = str_src_code\
+        .replace("{{LITMUS_TABLE_DECLS}}", table_decls)\
+        .replace("{{FUNC_BODY_ADD_CPU_INSTR}}", str_table_add_instr)\
+        .replace("{{FUNC_BODY_FORBIDDEN}}", str_table_outcome
+                 .replace("{{OUTCOME_KIND}}", "0")
+                 .replace("{{ACTION}}", "return false"))\
+        .replace("{{FUNC_BODY_EXPECTED}}", str_table_outcome
+                 .replace("{{OUTCOME_KIND}}", "1")
+                 .replace("{{ACTION}}", "put \"expected outcome appeared\""))\
+        .replace("{{FUNC_BODY_ADDR_TO_DIR}}", "\t\t\treturn DirOfIdx(LitmusAddrDir(adr))")\
+        .replace("{{RECORD_OUTCOME}}", "Record_Outcome();")
+    # what is left are the shape values
+    return build_murphi_src_code_form_config(config, src_code,
+                                             "", "", "", "", "")
+
+
+def build_litmus_table_from_config(config, config_name, shape_src_file, str_src_code):
+    # see src/template/LitmusTable.h for the format
+    acc_types = enum_values(str_src_code, "AccType")
+    acc_csts = enum_values(str_src_code, "AccCst")
+    lines = [f"# {config_name}", f"shape {shape_src_file}"]
+    for cpu_instr in config["LITMUS_TEST"]:
+        cpu_idx = cpu_instr["CPU_IDX"]
+        for instr in cpu_instr["INSTR_STREAM"]:
+            lines.append(f"instr {cpu_idx} {instr['INSTR_IDX']} "
+                         f"{acc_types.index(instr['INSTR_ACC'])} "
+                         f"{acc_csts.index(instr['INSTR_CST'])} "
+                         f"{instr['INSTR_ADDR']} {instr['INSTR_VAL']}")
+    for addr_to_dir in config["ADDR_TO_DIR"]:
+        lines.append(f"addr {addr_to_dir['ADDR']} {addr_to_dir['DIR']}")
+    # as in build_murphi_src_code_form_config, expected outcomes only
+    # check loads
+    for kind, check, outcomes, val_outcomes in ((0, "CHECK_FORBIDDEN", "FORBIDDEN_OUTCOME", True),
+                                                (1, "CHECK_EXPECTED", "EXPECTED_OUTCOME", False)):
+        if check not in config or config[check] != 1:
+            continue
+        for outcome_idx, outcome in enumerate(config[outcomes]):
+            lines.append(f"outcome {kind} {outcome_idx}")
+            for one_load_outcome in outcome.get("LOAD_OUTCOME", []):
+                lines.append(f"load {kind} {outcome_idx} {one_load_outcome['CPU_IDX']} "
+                             f"{one_load_outcome['INSTR_IDX']} {one_load_outcome['INSTR_VAL']}")
+            if val_outcomes:
+                for one_val_outcome in outcome.get("VAL_OUTCOME", []):
+                    lines.append(f"mem {kind} {outcome_idx} {one_val_outcome['ADDR']} "
+                                 f"{one_val_outcome['VAL']}")
+    return "\n".join(lines) + "\n"
+
+
+def main(murphiTempFile, configFiles, shapes=False):
     if not murphiTempFile.endswith('.m'):
         print("Error: murphiTempFile must end with .m")
         return
@@ -217,6 +322,10 @@ def main(murphiTempFile, configFiles):
     str_check_one_load = read_file(os.path.join(default_temp_dir, temp_check_one_load))
     str_check_one_val = read_file(os.path.join(default_temp_dir, temp_check_one_val))
     # str_map_one_cpu_cache = read_file(os.path.join(default_src_dir, temp_map_one_cpu_cache))
+    str_table_decls = read_file(os.path.join(default_temp_dir, temp_table_decls))
+    str_table_add_instr = read_file(os.path.join(default_temp_dir, temp_table_add_instr))
+    str_table_outcome = read_file(os.path.join(default_temp_dir, temp_table_outcome))
+    shape_src_files = set()
 
     for configFile in configFiles:
         if not configFile.endswith('.yaml') and not configFile.endswith('.yml'):
@@ -227,6 +336,30 @@ def main(murphiTempFile, configFiles):
         config_content = read_file(configFile)
         config = yaml.safe_load(config_content)
 
+        config_base_name = os.path.splitext(os.path.basename(configFile))[0]
+        murphi_base_name = os.path.splitext(os.path.basename(murphiTempFile))[0]
+
+        if shapes:
+            # one model per shape, one table per config
+            shape_src_file = shape_name(murphi_base_name, str_src_code, config) + ".m"
+            if shape_src_file not in shape_src_files:
+                src_code = build_murphi_shape_src_code_from_config(config,
+                                                                   str_src_code,
+                                                                   str_table_decls,
+                                                                   str_table_add_instr,
+                                                                   str_table_outcome,
+                                                                   )
+                write_file(os.path.join(default_src_dir, shape_src_file), src_code)
+                shape_src_files.add(shape_src_file)
+                print(f"Generated file: {os.path.join(default_src_dir, shape_src_file)}")
+            table_file = os.path.join(default_src_dir, f"{murphi_base_name}.{config_base_name}.lit")
+            write_file(table_file, build_litmus_table_from_config(config,
+                                                                  config_base_name,
+                                                                  shape_src_file,
+                                                                  str_src_code))
+            print(f"Generated file: {table_file}")
+            continue
+
         # Replace variables in the template
         # new_content = replace_variables(template_content, config)
         src_code = build_murphi_src_code_form_config(config,
@@ -240,17 +373,18 @@ def main(murphiTempFile, configFiles):
                                                     )
         
         # Generate the output file name
-        config_base_name = os.path.splitext(os.path.basename(configFile))[0]
-        murphi_base_name = os.path.splitext(os.path.basename(murphiTempFile))[0]
         murphi_src_file = os.path.join(default_src_dir, f"{murphi_base_name}.{config_base_name}.m")
         
         write_file(murphi_src_file, src_code)
         print(f"Generated file: {murphi_src_file}")
 
 if __name__ == "__main__":
-    if len(sys.argv) < 3:
-        print("Usage: python tempToMurphiSrc.py <murphiTempFile.m> [ConfigFile1.yaml ConfigFile2.yaml ...]")
+    # --shapes: generate one model per shape and a litmus table per config
+    shapes = len(sys.argv) > 1 and sys.argv[1] == "--shapes"
+    args = sys.argv[2:] if shapes else sys.argv[1:]
+    if len(args) < 2:
+        print("Usage: python tempToMurphiSrc.py [--shapes] <murphiTempFile.m> [ConfigFile1.yaml ConfigFile2.yaml ...]")
     else:
-        murphiTempFile = sys.argv[1]
-        configFiles = sys.argv[2:]  # Remaining arguments are config files
-        main(murphiTempFile, configFiles)
\ No newline at end of file
+        murphiTempFile = args[0]
+        configFiles = args[1:]  # Remaining arguments are config files
+        main(murphiTempFile, configFiles, shapes)
\ No newline at end of file
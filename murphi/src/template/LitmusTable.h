@@ -0,0 +1,232 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: LicenseRef-NvidiaProprietary
+ *
+ * NVIDIA CORPORATION, its affiliates and licensors retain all intellectual
+ * property and proprietary rights in and to this material, related
+ * documentation and any modifications thereto. Any use, reproduction,
+ * disclosure or distribution of this material and related documentation
+ * without an express license agreement from NVIDIA CORPORATION or
+ * its affiliates is strictly prohibited.
+ */
+
+// Litmus test tables of the verifiers built from a shape model
+// (tempToMurphiSrc.py --shapes). The instruction streams, the address to
+// directory map and the outcomes to check are read from the table file
+// named by $LITMUS_TABLE the first time they are needed, so one verifier
+// serves every litmus test of the same shape.
+//
+// Table file lines (# starts a comment):
+//   shape <shape model>
+//   instr <cpu> <idx> <access> <consistency> <address> <value>
+//   addr <address> <dir>
+//   outcome <kind> <outcome>
+//   load <kind> <outcome> <cpu> <instr> <value>
+//   mem <kind> <outcome> <address> <value>
+// with kind 0 for forbidden and 1 for expected outcomes, and access and
+// consistency given as their position in AccType and AccCst.
+//
+// If $LITMUS_OUTCOMES names a file, the outcomes are not checked: every
+// distinct final outcome reached is written to that file instead, one
+// line each, as "<cpu>.<instr>=<value>" for the loads followed by
+// "[<address>]=<value>" for the memory. Parallel workers share the file
+// and may each write the same outcome once.
+
+#ifndef _LITMUS_TABLE_H_
+#define _LITMUS_TABLE_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <set>
+#include <string>
+#include <vector>
+
+class litmus_table {
+  struct row {
+    int field[4];
+  };
+
+  std::vector < std::vector < row > >instrs;	// [cpu][idx]
+  std::vector < int >addr_dir;	// [address]
+  std::vector < std::vector < row > >outcomes[2];	// [kind][outcome][cond]
+
+  int outcome_file;		// outcome enumeration, or -1
+  std::string outcome_line;	// the outcome being recorded
+  std::set < std::string > outcomes_seen;	// by this worker
+
+  template < class T > static T & at(std::vector < T > &v, int i) {
+    if (i < 0)
+      Error.Notrace("Negative index in litmus table.");
+    if ((unsigned) i >= v.size())
+      v.resize(i + 1);
+    return v[i];
+  }
+
+  static void read_ints(FILE * f, const char *file, int *v, int n) {
+    for (int i = 0; i < n; i++)
+      if (fscanf(f, "%d", &v[i]) != 1)
+	Error.Notrace("Malformed line in litmus table %s.", file);
+  }
+
+  std::vector < row > &outcome(const char *file, int kind, int o) {
+    if (kind < 0 || kind > 1)
+      Error.Notrace("Unknown outcome kind %d in litmus table %s.", kind,
+		    file);
+    return at(outcomes[kind], o);
+  }
+
+  void load() {
+    const char *file = getenv("LITMUS_TABLE");
+    char word[256];
+    int v[6];
+
+    if (file == NULL)
+      Error.Notrace("LITMUS_TABLE is not set.");
+    FILE *f = fopen(file, "r");
+    if (f == NULL)
+      Error.Notrace("Cannot open litmus table %s.", file);
+
+    while (fscanf(f, "%255s", word) == 1) {
+      if (word[0] == '#' || strcmp(word, "shape") == 0) {
+	int c;
+	while ((c = fgetc(f)) != EOF && c != '\n');
+      } else if (strcmp(word, "instr") == 0) {
+	read_ints(f, file, v, 6);
+	row r = { {v[2], v[3], v[4], v[5]} };
+	at(at(instrs, v[0]), v[1]) = r;
+      } else if (strcmp(word, "addr") == 0) {
+	read_ints(f, file, v, 2);
+	at(addr_dir, v[0]) = v[1];
+      } else if (strcmp(word, "outcome") == 0) {
+	read_ints(f, file, v, 2);
+	(void) outcome(file, v[0], v[1]);
+      } else if (strcmp(word, "load") == 0) {
+	read_ints(f, file, v, 5);
+	row r = { {0, v[2], v[3], v[4]} };
+	outcome(file, v[0], v[1]).push_back(r);
+      } else if (strcmp(word, "mem") == 0) {
+	read_ints(f, file, v, 4);
+	row r = { {1, v[2], 0, v[3]} };
+	outcome(file, v[0], v[1]).push_back(r);
+      } else
+	Error.Notrace("Unknown line \"%s\" in litmus table %s.", word, file);
+    }
+    fclose(f);
+
+    const char *outcome_name = getenv("LITMUS_OUTCOMES");
+    outcome_file = -1;
+    if (outcome_name != NULL) {
+      outcome_file =
+	  open(outcome_name, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+      if (outcome_file < 0)
+	Error.Notrace("Cannot open outcome file %s.", outcome_name);
+    }
+  }
+
+public:
+  static litmus_table & get() {
+    static litmus_table *table = NULL;
+    if (table == NULL) {
+      table = new litmus_table;
+      table->load();
+    }
+    return *table;
+  }
+
+  int instr_cnt(int cpu) {
+    return (unsigned) cpu < instrs.size()? instrs[cpu].size() : 0;
+  }
+  int instr(int cpu, int idx, int field) {
+    return instrs[cpu][idx].field[field];
+  }
+  int addr_to_dir(int adr) {
+    return (unsigned) adr < addr_dir.size()? addr_dir[adr] : 0;
+  }
+  int outcome_cnt(int kind) {
+    return outcome_file < 0 ? outcomes[kind].size() : 0;
+  }
+  int cond_cnt(int kind, int o) {
+    return outcomes[kind][o].size();
+  }
+  int cond(int kind, int o, int c, int field) {
+    return outcomes[kind][o][c].field[field];
+  }
+
+  void outcome_begin() {
+    outcome_line.clear();
+  }
+  void outcome_add(const char *fmt, int a, int b, int c) {
+    char buf[64];
+    if (outcome_file < 0)
+      return;
+    snprintf(buf, sizeof(buf), fmt, a, b, c);
+    if (!outcome_line.empty())
+      outcome_line += ' ';
+    outcome_line += buf;
+  }
+  void outcome_end() {
+    if (outcome_file < 0 || !outcomes_seen.insert(outcome_line).second)
+      return;
+    // one write, so that workers appending together do not mix lines
+    std::string line = outcome_line + '\n';
+    if (write(outcome_file, line.data(), line.size()) !=
+	(ssize_t) line.size())
+      Error.Notrace("Cannot write the outcome file.");
+  }
+};
+
+/* the external functions and procedures of TableDecls.m */
+int LitmusInstrCnt(int cpu)
+{
+  return litmus_table::get().instr_cnt(cpu);
+}
+
+int LitmusInstr(int cpu, int idx, int field)
+{
+  return litmus_table::get().instr(cpu, idx, field);
+}
+
+int LitmusAddrDir(int adr)
+{
+  return litmus_table::get().addr_to_dir(adr);
+}
+
+int LitmusOutcomeCnt(int kind)
+{
+  return litmus_table::get().outcome_cnt(kind);
+}
+
+int LitmusCondCnt(int kind, int o)
+{
+  return litmus_table::get().cond_cnt(kind, o);
+}
+
+int LitmusCond(int kind, int o, int c, int field)
+{
+  return litmus_table::get().cond(kind, o, c, field);
+}
+
+void LitmusOutcomeBegin()
+{
+  litmus_table::get().outcome_begin();
+}
+
+void LitmusOutcomeLoad(int cpu, int idx, int val)
+{
+  litmus_table::get().outcome_add("%d.%d=%d", cpu, idx, val);
+}
+
+void LitmusOutcomeMem(int adr, int val)
+{
+  litmus_table::get().outcome_add("[%d]=%d", adr, val, 0);
+}
+
+void LitmusOutcomeEnd()
+{
+  litmus_table::get().outcome_end();
+}
+
+#endif
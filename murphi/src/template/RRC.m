@@ -218,6 +218,8 @@ var
         endfor;
     end;
 
+{{LITMUS_TABLE_DECLS}}
+
     function CPU_Next(cur: OBJSET_CPU): OBJSET_CPU;
     begin
 {{FUNC_BODY_CPU_NEXT}}
@@ -1008,6 +1010,7 @@ var
         rule "CPU_done"
             All_CPU_done()
         ==>
+          {{RECORD_OUTCOME}}
           /* Evaluate invariants */
           if !Forbidden() then
             error "Litmus Test Failed";
@@ -0,0 +1,27 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: LicenseRef-NvidiaProprietary
+ *
+ * NVIDIA CORPORATION, its affiliates and licensors retain all intellectual
+ * property and proprietary rights in and to this material, related
+ * documentation and any modifications thereto. Any use, reproduction,
+ * disclosure or distribution of this material and related documentation
+ * without an express license agreement from NVIDIA CORPORATION or
+ * its affiliates is strictly prohibited.
+ */
+
+
+      for c := 0 to CPU_COUNT-1 do
+        alias cpu:cpus[CpuOfIdx(c)] do
+        alias q: cpu.instrs.Queue do
+          for i := 0 to LitmusInstrCnt(c)-1 do
+            q[i].access := AccOfCode(LitmusInstr(c, i, 0));
+            q[i].cst := CstOfCode(LitmusInstr(c, i, 1));
+            q[i].adr := LitmusInstr(c, i, 2);
+            q[i].val := LitmusInstr(c, i, 3);
+            q[i].done := false;
+          endfor;
+          cpu.instrs.Cnt := LitmusInstrCnt(c);
+        endalias;
+        endalias;
+      endfor;
@@ -0,0 +1,87 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: LicenseRef-NvidiaProprietary
+ *
+ * NVIDIA CORPORATION, its affiliates and licensors retain all intellectual
+ * property and proprietary rights in and to this material, related
+ * documentation and any modifications thereto. Any use, reproduction,
+ * disclosure or distribution of this material and related documentation
+ * without an express license agreement from NVIDIA CORPORATION or
+ * its affiliates is strictly prohibited.
+ */
+
+
+    -- litmus test tables, read at startup from the file named by
+    -- $LITMUS_TABLE (see LitmusTable.h)
+    externfun LitmusInstrCnt(cpu: 0..CPU_COUNT-1): InstrCnt "LitmusTable.h";
+    -- field: 0 access, 1 consistency, 2 address, 3 value
+    externfun LitmusInstr(cpu: 0..CPU_COUNT-1; idx: 0..INSTR_COUNT-1; field: 0..3): 0..255;
+    externfun LitmusAddrDir(adr: Address): 0..DIR_COUNT-1;
+    -- kind: 0 forbidden, 1 expected
+    externfun LitmusOutcomeCnt(kind: 0..1): 0..255;
+    externfun LitmusCondCnt(kind: 0..1; o: 0..255): 0..255;
+    -- field: 0 load (0) or memory (1) condition, 1 cpu or address,
+    -- 2 instruction, 3 value
+    externfun LitmusCond(kind: 0..1; o: 0..255; c: 0..255; field: 0..3): 0..255;
+    -- outcome enumeration: record the final loads and memory values
+    -- to the file named by $LITMUS_OUTCOMES
+    externproc LitmusOutcomeBegin();
+    externproc LitmusOutcomeLoad(cpu: 0..CPU_COUNT-1; idx: 0..INSTR_COUNT-1; val: ClValue);
+    externproc LitmusOutcomeMem(adr: Address; val: ClValue);
+    externproc LitmusOutcomeEnd();
+
+    function CpuOfIdx(idx: 0..CPU_COUNT-1): OBJSET_CPU;
+    begin
+{{FUNC_BODY_CPU_OF_IDX}}
+    end;
+
+    function DirOfIdx(idx: 0..DIR_COUNT-1): OBJSET_dir;
+    begin
+{{FUNC_BODY_DIR_OF_IDX}}
+    end;
+
+    function AccOfCode(code: 0..255): AccType;
+    begin
+{{FUNC_BODY_ACC_OF_CODE}}
+    end;
+
+    function CstOfCode(code: 0..255): AccCst;
+    begin
+{{FUNC_BODY_CST_OF_CODE}}
+    end;
+
+    function OutcomeSeen(kind: 0..1; o: 0..255): boolean;
+    var a: Address;
+    begin
+      for c := 0 to LitmusCondCnt(kind, o)-1 do
+        if LitmusCond(kind, o, c, 0) = 0 then
+          if cpus[CpuOfIdx(LitmusCond(kind, o, c, 1))].instrs.Queue[LitmusCond(kind, o, c, 2)].val != LitmusCond(kind, o, c, 3) then
+            return false;
+          endif;
+        else
+          a := LitmusCond(kind, o, c, 1);
+          if dirs[DirOfIdx(LitmusAddrDir(a))].cb[a].cl != LitmusCond(kind, o, c, 3) then
+            return false;
+          endif;
+        endif;
+      endfor;
+      return true;
+    end;
+
+    procedure Record_Outcome();
+    begin
+      LitmusOutcomeBegin();
+      for c := 0 to CPU_COUNT-1 do
+        alias q: cpus[CpuOfIdx(c)].instrs do
+        for i := 0 to q.Cnt-1 do
+          if q.Queue[i].access = load then
+            LitmusOutcomeLoad(c, i, q.Queue[i].val);
+          endif;
+        endfor;
+        endalias;
+      endfor;
+      for a: Address do
+        LitmusOutcomeMem(a, dirs[DirOfIdx(LitmusAddrDir(a))].cb[a].cl);
+      endfor;
+      LitmusOutcomeEnd();
+    end;
@@ -0,0 +1,102 @@
+# SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION &
+# AFFILIATES. All rights reserved.
+# SPDX-License-Identifier: LicenseRef-NvidiaProprietary
+#
+# NVIDIA CORPORATION, its affiliates and licensors retain all intellectual
+# property and proprietary rights in and to this material, related
+# documentation and any modifications thereto. Any use, reproduction,
+# disclosure or distribution of this material and related documentation
+# without an express license agreement from NVIDIA CORPORATION or
+# its affiliates is strictly prohibited.
+
+# Compares the stats of a --parallel-nodes run against the same run done
+# serially with --parallel-reference (see scripts/run_parallel_check.sh).
+# Host stats are skipped; every other stat of every dump must match within
+# --tolerance. Exits with 1 if any stat differs or is missing.
+
+import argparse
+import sys
+
+BEGIN = "---------- Begin Simulation Statistics ----------"
+
+def read_dumps(statsfile):
+    dumps = []
+    with open(statsfile, 'r') as stats:
+        for line in stats:
+            if line.startswith(BEGIN):
+                dumps.append({})
+                continue
+            parts = line.split('#')[0].split()
+            if len(parts) < 2 or not dumps:
+                continue
+            # distributions print several values per stat; keep them all
+            dumps[-1][parts[0]] = parts[1:]
+    return dumps
+
+def to_float(value):
+    try:
+        return float(value.rstrip('%'))
+    except ValueError:
+        return None
+
+def differs(serial, parallel, tolerance):
+    if len(serial) != len(parallel):
+        return True
+    for s, p in zip(serial, parallel):
+        if s == p:
+            continue
+        s_val, p_val = to_float(s), to_float(p)
+        if s_val is None or p_val is None:
+            return True
+        if abs(s_val - p_val) > tolerance * max(abs(s_val), abs(p_val)):
+            return True
+    return False
+
+def host_seconds(dumps):
+    for dump in reversed(dumps):
+        if "host_seconds" in dump:
+            return to_float(dump["host_seconds"][0])
+    return None
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("serial", help="stats.txt of the serial run")
+    parser.add_argument("parallel", help="stats.txt of the --parallel-nodes run")
+    parser.add_argument("--tolerance", type=float, default=0.0,
+                        help="allowed relative difference (0: bit-exact)")
+    parser.add_argument("--max-print", type=int, default=50,
+                        help="differing stats to print per dump")
+    args = parser.parse_args()
+
+    serial_dumps = read_dumps(args.serial)
+    parallel_dumps = read_dumps(args.parallel)
+    failed = False
+    if len(serial_dumps) != len(parallel_dumps):
+        print(f"dump count differs: serial {len(serial_dumps)}, "
+              f"parallel {len(parallel_dumps)}")
+        failed = True
+
+    for (i, (serial, parallel)) in enumerate(zip(serial_dumps,
+                                                 parallel_dumps)):
+        names = sorted(set(serial) | set(parallel))
+        names = [n for n in names if not n.startswith("host_")]
+        missing = [n for n in names if n not in serial or n not in parallel]
+        diff = [n for n in names if n in serial and n in parallel and
+                differs(serial[n], parallel[n], args.tolerance)]
+        print(f"dump {i}: {len(names)} stats, {len(diff)} differ, "
+              f"{len(missing)} missing")
+        for n in diff[:args.max_print]:
+            print(f"  {n}: serial {' '.join(serial[n])}, "
+                  f"parallel {' '.join(parallel[n])}")
+        for n in missing[:args.max_print]:
+            print(f"  {n}: only in {'serial' if n in serial else 'parallel'}")
+        failed = failed or bool(diff) or bool(missing)
+
+    serial_time = host_seconds(serial_dumps)
+    parallel_time = host_seconds(parallel_dumps)
+    if serial_time and parallel_time:
+        print(f"host seconds: serial {serial_time:.2f}, "
+              f"parallel {parallel_time:.2f}, "
+              f"speedup {serial_time / parallel_time:.2f}x")
+
+    sys.exit(1 if failed else 0)
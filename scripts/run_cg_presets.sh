@@ -0,0 +1,28 @@
+#!/bin/bash
+
+ # SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ # SPDX-License-Identifier: LicenseRef-NvidiaProprietary
+ #
+ # NVIDIA CORPORATION, its affiliates and licensors retain all intellectual
+ # property and proprietary rights in and to this material, related
+ # documentation and any modifications thereto. Any use, reproduction,
+ # disclosure or distribution of this material and related documentation
+ # without an express license agreement from NVIDIA CORPORATION or
+ # its affiliates is strictly prohibited.
+
+# PAD_RC_CXL and PAD_RC_UPI under each CG link preset, bandwidth model on.
+# The CG link latency comes from the preset (150 cycles for cxl, 50 for upi).
+# Compare system.ruby.network.CG_link_flits_count and the ROI time across
+# the preset pairs of each benchmark.
+
+exp_id=980
+presets=("cxl" "upi")
+benchmarks=("PAD_RC_CXL" "PAD_RC_UPI")
+sys="DO_MESI"
+
+for benchmark in "${benchmarks[@]}"; do
+    for preset in "${presets[@]}"; do
+        nohup /artifact_top/alloy-gem5/build/RISCV_${sys}_64B/gem5.opt --stats-file=stats${exp_id}.txt --debug-flags=DOMEM,DOACC --listener-mode=off /artifact_top/alloy-gem5/configs/brg/sc3.py --cpu-type TimingSimpleCPU --link-latency 20 --CG-link-preset ${preset} --garnet-deadlock-threshold 100000 --l2_size 16384kB --l2_assoc 8 --num-dirs 8 --brg-fast-forward --num-cpus 64 --network garnet2.0 --buffer-size 0 --mem-size 16GB --ruby --l1d_size 64kB --mem-type SimpleMemory --num-l1-cache-ports 8 --num-l2caches 8 --ports 16 --l1i_size 64kB --topology TwoMeshXY -c /artifact_top/alloy-apps/build-applrts_sc3/${benchmark} -o "-w 0 -r 1 -n 8 -c 8 -t 8 -p 1" --vcs-per-vnet 64 --buffers-per-data-vc 65536 --buffers-per-ctrl-vc 1024 > logs/log${exp_id}.txt &
+        exp_id=$((exp_id + 1))
+    done
+done
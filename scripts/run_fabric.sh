@@ -0,0 +1,26 @@
+#!/bin/bash
+
+ # SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ # SPDX-License-Identifier: LicenseRef-NvidiaProprietary
+ #
+ # NVIDIA CORPORATION, its affiliates and licensors retain all intellectual
+ # property and proprietary rights in and to this material, related
+ # documentation and any modifications thereto. Any use, reproduction,
+ # disclosure or distribution of this material and related documentation
+ # without an express license agreement from NVIDIA CORPORATION or
+ # its affiliates is strictly prohibited.
+
+exp_id=900
+fabrics=("switch" "multi_switch" "ring" "mesh" "torus" "fc")
+nodes=("8" "16")
+sys="DO_MESI"
+
+for node in "${nodes[@]}"; do
+    num_cpus=$((node * 8))
+    for fabric in "${fabrics[@]}"; do
+        nohup /artifact_top/alloy-gem5/build/RISCV_${sys}_64B/gem5.opt --stats-file=stats${exp_id}.txt --listener-mode=off /artifact_top/alloy-gem5/configs/brg/sc3.py --cpu-type TimingSimpleCPU --link-latency 20 --CG_link_latency 150 --inter-node-fabric ${fabric} --routing-algorithm 3 --garnet-deadlock-threshold 100000 --l2_size 16384kB --l2_assoc 8 --num-dirs ${node} --brg-fast-forward --num-cpus ${num_cpus} --network garnet2.0 --buffer-size 0 --mem-size 4GB --ruby --l1d_size 64kB --mem-type SimpleMemory --num-l1-cache-ports 8 --num-l2caches ${node} --ports 16 --l1i_size 64kB --topology TwoMeshXY -c /artifact_top/alloy-apps/build-applrts_sc3/run_alltoall -o "-w 0 -r 1 -n ${node} -c 8 -t 8 -f 2560 -s 8 -v 0" --vcs-per-vnet 64 --buffers-per-data-vc 65536 --buffers-per-ctrl-vc 1024 > logs/log${exp_id}.txt &
+        exp_id=$((exp_id + 1))
+        nohup /artifact_top/alloy-gem5/build/RISCV_${sys}_64B/gem5.opt --stats-file=stats${exp_id}.txt --listener-mode=off /artifact_top/alloy-gem5/configs/brg/sc3.py --cpu-type TimingSimpleCPU --link-latency 20 --CG_link_latency 150 --inter-node-fabric ${fabric} --routing-algorithm 3 --garnet-deadlock-threshold 100000 --l2_size 16384kB --l2_assoc 8 --num-dirs ${node} --brg-fast-forward --num-cpus ${num_cpus} --network garnet2.0 --buffer-size 0 --mem-size 4GB --ruby --l1d_size 64kB --mem-type SimpleMemory --num-l1-cache-ports 8 --num-l2caches ${node} --ports 16 --l1i_size 64kB --topology TwoMeshXY -c /artifact_top/alloy-apps/build-applrts_sc3/run_allreduce -o "-w 0 -r 2 -n ${node} -c 8 -t 1 -f 128 -s 1000 -v 0" --vcs-per-vnet 64 --buffers-per-data-vc 65536 --buffers-per-ctrl-vc 1024 > logs/log${exp_id}.txt &
+        exp_id=$((exp_id + 1))
+    done
+done
@@ -0,0 +1,40 @@
+#!/bin/bash
+
+ # SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ # SPDX-License-Identifier: LicenseRef-NvidiaProprietary
+ #
+ # NVIDIA CORPORATION, its affiliates and licensors retain all intellectual
+ # property and proprietary rights in and to this material, related
+ # documentation and any modifications thereto. Any use, reproduction,
+ # disclosure or distribution of this material and related documentation
+ # without an express license agreement from NVIDIA CORPORATION or
+ # its affiliates is strictly prohibited.
+
+# Runs each benchmark with --parallel-reference (serial, same handoffs) and
+# with --parallel-nodes, then diffs the stats and reports the speedup
+# (scripts/compare_parallel_stats.py). Check a workload here before using
+# --parallel-nodes for its results.
+
+exp_id=950
+sys="DO_MESI"
+benchmarks=(
+    "run_alltoall|-w 0 -r 10 -n 8 -c 8 -t 8 -f 128 -s 8 -v 0 -b 0"
+    "run_allreduce|-w 0 -r 2 -n 8 -c 8 -t 1 -f 128 -s 1000 -v 0"
+    "PAD_no_local_wt|-w 0 -r 1 -n 8 -c 8 -t 8 -p 1"
+)
+
+mkdir -p logs
+for benchmark in "${benchmarks[@]}"; do
+    binary="${benchmark%%|*}"
+    opts="${benchmark#*|}"
+    for mode in "serial" "parallel"; do
+        flag="--parallel-reference"
+        if [ "${mode}" == "parallel" ]; then
+            flag="--parallel-nodes"
+        fi
+        /artifact_top/alloy-gem5/build/RISCV_${sys}_64B/gem5.opt --outdir=m5out_${exp_id}_${mode} --listener-mode=off /artifact_top/alloy-gem5/configs/brg/sc3.py ${flag} --cpu-type TimingSimpleCPU --link-latency 20 --CG_link_latency 150 --garnet-deadlock-threshold 100000 --l2_size 16384kB --l2_assoc 8 --num-dirs 8 --brg-fast-forward --num-cpus 64 --network garnet2.0 --buffer-size 0 --mem-size 16GB --ruby --l1d_size 64kB --mem-type SimpleMemory --num-l1-cache-ports 8 --num-l2caches 8 --ports 16 --l1i_size 64kB --topology TwoMeshXY -c /artifact_top/alloy-apps/build-applrts_sc3/${binary} -o "${opts}" --vcs-per-vnet 64 --buffers-per-data-vc 65536 --buffers-per-ctrl-vc 1024 > logs/log${exp_id}_${mode}.txt
+    done
+    echo "${binary}:"
+    python3 compare_parallel_stats.py m5out_${exp_id}_serial/stats.txt m5out_${exp_id}_parallel/stats.txt
+    exp_id=$((exp_id + 1))
+done